@@ -19,17 +19,19 @@ using namespace Ampliar::DS3231;
 using Ampliar::BinaryHelper::setBitOn;
 using Ampliar::BinaryHelper::setBitOff;
 using Ampliar::BinaryHelper::isBitSet;
-using Ampliar::BinaryHelper::fromBcdToDecimal;
-using Ampliar::BinaryHelper::fromDecimalToBcd;
+using Ampliar::BinaryHelper::bcdToDecimal;
+using Ampliar::BinaryHelper::decimalToBcd;
 
 /**
  * Constructor.
  *
  * This constructor does not read any information from the device. Therefore, if you try to call any getter, it will
  * return the values initialized here (i.e., zero).
+ *
+ * @param device The device of the alarm (the default device, if omitted).
  */
-Alarm1::Alarm1():
-    BaseAlarm(RTC_REG_CONTROL_A1IE, RTC_REG_STATUS_A1F),
+Alarm1::Alarm1(Device& device):
+    BaseAlarm(device, RTC_REG_CONTROL_A1IE, RTC_REG_STATUS_A1F, RTC_ADDR_ALARM1, 4),
     _second(0), _minute(0), _day(0), _hour(0), _dayOfWeek(0),
     _alarmRate(ALARM1_UNDEFINED)
 {
@@ -43,19 +45,46 @@ Alarm1::Alarm1():
  * object and make them available through getters, like getHour(), getMinute(), getAlarmRate(), etc.
  *
  * \b Note: you must call this method before using any getter, otherwise they will return zero or undefined.
+ *
+ * @return True if successful, or false if the I2C transfer failed (this object is left unchanged).
  */
-void Alarm1::readAlarm()
+bool Alarm1::readAlarm()
 {
-    Wire.beginTransmission(RTC_ADDR_I2C);
-    Wire.write(RTC_ADDR_ALARM1);
-    Wire.endTransmission();
+    uint8_t registers[4];
+    if (!readRegisters(RTC_ADDR_ALARM1, registers, 4))
+    {
+        return false;
+    }
+
+    decodeAlarm(registers);
+    return true;
+}
+
+/**
+ * Retrieves settings of the first alarm from a snapshot of the registers.
+ *
+ * This method works like readAlarm(), but it decodes the alarm from a snapshot previously read by
+ * BaseClock::readSnapshot(). Therefore, it does not communicate with the device.
+ *
+ * @param snapshot The snapshot of the registers.
+ */
+void Alarm1::readAlarm(const RegisterSnapshot& snapshot)
+{
+    decodeAlarm(snapshot.getRegisters(RTC_ADDR_ALARM1));
+}
 
+/**
+ * Decodes the alarm registers and stores the values in this object.
+ *
+ * @param registers The content of the 4 (four) alarm registers, starting at RTC_ADDR_ALARM1.
+ */
+void Alarm1::decodeAlarm(const uint8_t* registers)
+{
     //Gets raw data
-    Wire.requestFrom(RTC_ADDR_I2C, 4);
-    _second    = Wire.read();
-    _minute    = Wire.read();
-    _hour      = Wire.read();
-    _day       = Wire.read();
+    _second    = registers[0];
+    _minute    = registers[1];
+    _hour      = registers[2];
+    _day       = registers[3];
 
     //Gets the flags used to determine the alarm rate
     bool a1m1        = isBitSet(_second, RTC_ALARM1_A1M1);
@@ -98,10 +127,10 @@ void Alarm1::readAlarm()
     setBitOff(_day   , RTC_ALARM1_DYDT);
 
     //Gets the actual values
-    _second = fromBcdToDecimal(_second);
-    _minute = fromBcdToDecimal(_minute);
-    _hour   = fromBcdToDecimal(_hour);
-    _day    = fromBcdToDecimal(_day);
+    _second = bcdToDecimal(_second);
+    _minute = bcdToDecimal(_minute);
+    _hour   = bcdToDecimal(_hour);
+    _day    = bcdToDecimal(_day);
 
     /* This device uses the same place to store the the day of the month and the
      * day of the week. Therefore, we need to figure out what the value in _day is.
@@ -117,6 +146,38 @@ void Alarm1::readAlarm()
     }
 }
 
+/**
+ * Encodes the settings held by this object into the alarm registers.
+ *
+ * @param registers The buffer that will receive the 4 (four) alarm registers, starting at RTC_ADDR_ALARM1.
+ * @return          True if successful, or false if the alarm rate is undefined.
+ */
+bool Alarm1::encodeAlarm(uint8_t* registers) const
+{
+    if (_alarmRate == ALARM1_UNDEFINED)
+    {
+        return false;
+    }
+
+    registers[0] = decimalToBcd(_second);
+    registers[1] = decimalToBcd(_minute);
+    registers[2] = decimalToBcd(_hour);
+    registers[3] = decimalToBcd(_day);
+
+    if (_alarmRate == WHEN_SECONDS_AND_MINUTES_AND_HOURS_AND_DAY_OF_WEEK_MATCH)
+    {
+        registers[3] = decimalToBcd(_dayOfWeek);
+        setBitOn(registers[3], RTC_ALARM1_DYDT);
+    }
+
+    //Each rate compares one more register, from the seconds up to the day; the others are masked (A1Mx set)
+    for (uint8_t i = _alarmRate - ONCE_PER_SECOND; i < 4; i++)
+    {
+        registers[i] = 0x80;
+    }
+    return true;
+}
+
 /**
  * Set the alarm to trigger once per second.
  *
@@ -129,20 +190,8 @@ void Alarm1::readAlarm()
  */
 void Alarm1::writeAlarmOncePerSecond()
 {
-    _second    = 0;
-    _minute    = 0;
-    _hour      = 0;
-    _day       = 0;
-    _dayOfWeek = 0;
-    _alarmRate = ONCE_PER_SECOND;
-
-    Wire.beginTransmission(RTC_ADDR_I2C);
-    Wire.write(RTC_ADDR_ALARM1);
-    Wire.write(0x80); //A1M1
-    Wire.write(0x80); //A1M2
-    Wire.write(0x80); //A1M3
-    Wire.write(0x80); //A1M4
-    Wire.endTransmission();
+    setAlarm(ONCE_PER_SECOND, 0, 0, 0, 0, 0);
+    writeAlarmRegisters();
 }
 
 /**
@@ -161,22 +210,8 @@ void Alarm1::writeAlarmOncePerSecond()
  */
 void Alarm1::writeAlarm(uint8_t second)
 {
-    _second    = second;
-    _minute    = 0;
-    _hour      = 0;
-    _day       = 0;
-    _dayOfWeek = 0;
-    _alarmRate = WHEN_SECONDS_MATCH;
-
-    second = fromDecimalToBcd(second);
-
-    Wire.beginTransmission(RTC_ADDR_I2C);
-    Wire.write(RTC_ADDR_ALARM1);
-    Wire.write(second);  //A1M1
-    Wire.write(0x80);    //A1M2
-    Wire.write(0x80);    //A1M3
-    Wire.write(0x80);    //A1M4
-    Wire.endTransmission();
+    setAlarm(WHEN_SECONDS_MATCH, 0, 0, 0, 0, second);
+    writeAlarmRegisters();
 }
 
 /**
@@ -196,23 +231,8 @@ void Alarm1::writeAlarm(uint8_t second)
  */
 void Alarm1::writeAlarm(uint8_t minute, uint8_t second)
 {
-    _second    = second;
-    _minute    = minute;
-    _hour      = 0;
-    _day       = 0;
-    _dayOfWeek = 0;
-    _alarmRate = WHEN_SECONDS_AND_MINUTES_MATCH;
-
-    second = fromDecimalToBcd(second);
-    minute = fromDecimalToBcd(minute);
-
-    Wire.beginTransmission(RTC_ADDR_I2C);
-    Wire.write(RTC_ADDR_ALARM1);
-    Wire.write(second);  //A1M1
-    Wire.write(minute);  //A1M2
-    Wire.write(0x80);    //A1M3
-    Wire.write(0x80);    //A1M4
-    Wire.endTransmission();
+    setAlarm(WHEN_SECONDS_AND_MINUTES_MATCH, 0, 0, 0, minute, second);
+    writeAlarmRegisters();
 }
 
 /**
@@ -233,24 +253,8 @@ void Alarm1::writeAlarm(uint8_t minute, uint8_t second)
  */
 void Alarm1::writeAlarm(uint8_t hour, uint8_t minute, uint8_t second)
 {
-    _second    = second;
-    _minute    = minute;
-    _hour      = hour;
-    _day       = 0;
-    _dayOfWeek = 0;
-    _alarmRate = WHEN_SECONDS_AND_MINUTES_AND_HOURS_MATCH;
-
-    second = fromDecimalToBcd(second);
-    minute = fromDecimalToBcd(minute);
-    hour   = fromDecimalToBcd(hour);
-
-    Wire.beginTransmission(RTC_ADDR_I2C);
-    Wire.write(RTC_ADDR_ALARM1);
-    Wire.write(second);  //A1M1
-    Wire.write(minute);  //A1M2
-    Wire.write(hour);    //A1M3
-    Wire.write(0x80);    //A1M4
-    Wire.endTransmission();
+    setAlarm(WHEN_SECONDS_AND_MINUTES_AND_HOURS_MATCH, 0, 0, hour, minute, second);
+    writeAlarmRegisters();
 }
 
 /**
@@ -276,32 +280,122 @@ void Alarm1::writeAlarm(uint8_t hour, uint8_t minute, uint8_t second)
  */
 void Alarm1::writeAlarm(bool useDayOfWeek, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second)
 {
-    _second    = second;
-    _minute    = minute;
-    _hour      = hour;
-    _day       = useDayOfWeek ? 0            : day;
-    _dayOfWeek = useDayOfWeek ? useDayOfWeek : 0 ;
-    _alarmRate = useDayOfWeek
-               ? WHEN_SECONDS_AND_MINUTES_AND_HOURS_AND_DAY_OF_WEEK_MATCH
-               : WHEN_SECONDS_AND_MINUTES_AND_HOURS_AND_DAY_MATCH;
+    if (useDayOfWeek)
+    {
+        setAlarm(WHEN_SECONDS_AND_MINUTES_AND_HOURS_AND_DAY_OF_WEEK_MATCH, 0, day, hour, minute, second);
+    }
+    else
+    {
+        setAlarm(WHEN_SECONDS_AND_MINUTES_AND_HOURS_AND_DAY_MATCH, day, 0, hour, minute, second);
+    }
+    writeAlarmRegisters();
+}
 
-    second = fromDecimalToBcd(second);
-    minute = fromDecimalToBcd(minute);
-    hour   = fromDecimalToBcd(hour);
-    day    = fromDecimalToBcd(day);
+/**
+ * Sets the first alarm to trigger once per second, turns it on and clears its flag in a single I2C transaction.
+ *
+ * @see writeAlarmOncePerSecond() and BaseAlarm::arm().
+ *
+ * @return True if successful or false, otherwise.
+ */
+bool Alarm1::armOncePerSecond()
+{
+    setAlarm(ONCE_PER_SECOND, 0, 0, 0, 0, 0);
+    return arm();
+}
+
+/**
+ * Sets the first alarm to trigger when seconds match, turns it on and clears its flag in a single I2C transaction.
+ *
+ * @see writeAlarm(uint8_t) and BaseAlarm::arm().
+ *
+ * @param second The seconds (from 0 to 59).
+ * @return       True if successful or false, otherwise.
+ */
+bool Alarm1::arm(uint8_t second)
+{
+    setAlarm(WHEN_SECONDS_MATCH, 0, 0, 0, 0, second);
+    return arm();
+}
+
+/**
+ * Sets the first alarm to trigger when minutes and seconds match, turns it on and clears its flag in a single I2C
+ * transaction.
+ *
+ * @see writeAlarm(uint8_t, uint8_t) and BaseAlarm::arm().
+ *
+ * @param minute The minutes (from 0 to 59).
+ * @param second The seconds (from 0 to 59).
+ * @return       True if successful or false, otherwise.
+ */
+bool Alarm1::arm(uint8_t minute, uint8_t second)
+{
+    setAlarm(WHEN_SECONDS_AND_MINUTES_MATCH, 0, 0, 0, minute, second);
+    return arm();
+}
+
+/**
+ * Sets the first alarm to trigger when hours, minutes and seconds match, turns it on and clears its flag in a single
+ * I2C transaction.
+ *
+ * @see writeAlarm(uint8_t, uint8_t, uint8_t) and BaseAlarm::arm().
+ *
+ * @param hour   The hours (from 0 to 23).
+ * @param minute The minutes (from 0 to 59).
+ * @param second The seconds (from 0 to 59).
+ * @return       True if successful or false, otherwise.
+ */
+bool Alarm1::arm(uint8_t hour, uint8_t minute, uint8_t second)
+{
+    setAlarm(WHEN_SECONDS_AND_MINUTES_AND_HOURS_MATCH, 0, 0, hour, minute, second);
+    return arm();
+}
 
+/**
+ * Sets the first alarm to trigger when the day (or day of week), hours, minutes and seconds match, turns it on and
+ * clears its flag in a single I2C transaction.
+ *
+ * @see writeAlarm(bool, uint8_t, uint8_t, uint8_t, uint8_t) and BaseAlarm::arm().
+ *
+ * @param useDayOfWeek Indicates if the parameter \b day must be interpreted as day of the week or day of the month.
+ * @param day          The day of the month (from 1 to 31) or the day of the week (from 1 to 7).
+ * @param hour         The hours (from 0 to 23).
+ * @param minute       The minutes (from 0 to 59).
+ * @param second       The seconds (from 0 to 59).
+ * @return             True if successful or false, otherwise.
+ */
+bool Alarm1::arm(bool useDayOfWeek, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second)
+{
     if (useDayOfWeek)
     {
-        setBitOn(day, RTC_ALARM1_DYDT);
+        setAlarm(WHEN_SECONDS_AND_MINUTES_AND_HOURS_AND_DAY_OF_WEEK_MATCH, 0, day, hour, minute, second);
+    }
+    else
+    {
+        setAlarm(WHEN_SECONDS_AND_MINUTES_AND_HOURS_AND_DAY_MATCH, day, 0, hour, minute, second);
     }
+    return arm();
+}
 
-    Wire.beginTransmission(RTC_ADDR_I2C);
-    Wire.write(RTC_ADDR_ALARM1);
-    Wire.write(second);  //A1M1
-    Wire.write(minute);  //A1M2
-    Wire.write(hour);    //A1M3
-    Wire.write(day);     //A1M4
-    Wire.endTransmission();
+/**
+ * Stores the settings of the alarm in this object, without writing them to the device.
+ *
+ * @param alarmRate The alarm rate.
+ * @param day       The day of the month (zero if not used).
+ * @param dayOfWeek The day of the week (zero if not used).
+ * @param hour      The hours.
+ * @param minute    The minutes.
+ * @param second    The seconds.
+ */
+void Alarm1::setAlarm(AlarmRate alarmRate, uint8_t day, uint8_t dayOfWeek, uint8_t hour, uint8_t minute,
+                      uint8_t second)
+{
+    _second    = second;
+    _minute    = minute;
+    _hour      = hour;
+    _day       = day;
+    _dayOfWeek = dayOfWeek;
+    _alarmRate = alarmRate;
 }
 
 /**
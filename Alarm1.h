@@ -17,7 +17,6 @@
 #define __AMPLIAR_DS3231_ALARM1_H__
 
 #include <stdint.h>
-#include <Wire.h>
 #include "BaseClock.h"
 #include "BinaryHelper.h"
 #include "BaseAlarm.h"
@@ -52,13 +51,20 @@ public:
     };
 
 public:
-    Alarm1();
-    void readAlarm();
+    explicit Alarm1(Device& device = BaseClock::getDefaultDevice());
+    bool readAlarm();
+    void readAlarm(const RegisterSnapshot& snapshot);
     void writeAlarmOncePerSecond();
     void writeAlarm(uint8_t second);
     void writeAlarm(uint8_t minute, uint8_t second);
     void writeAlarm(uint8_t hour, uint8_t minute, uint8_t second);
     void writeAlarm(bool useDayOfWeek, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second);
+    using BaseAlarm::arm;
+    bool armOncePerSecond();
+    bool arm(uint8_t second);
+    bool arm(uint8_t minute, uint8_t second);
+    bool arm(uint8_t hour, uint8_t minute, uint8_t second);
+    bool arm(bool useDayOfWeek, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second);
     uint8_t getSecond() const;
     uint8_t getMinute() const;
     uint8_t getHour() const;
@@ -73,6 +79,9 @@ private:
     uint8_t _hour;
     uint8_t _dayOfWeek;
     AlarmRate _alarmRate;
+    void decodeAlarm(const uint8_t* registers);
+    bool encodeAlarm(uint8_t* registers) const;
+    void setAlarm(AlarmRate alarmRate, uint8_t day, uint8_t dayOfWeek, uint8_t hour, uint8_t minute, uint8_t second);
 };
 
 }} //end of namespace
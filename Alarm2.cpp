@@ -19,17 +19,19 @@ using namespace Ampliar::DS3231;
 using Ampliar::BinaryHelper::setBitOn;
 using Ampliar::BinaryHelper::setBitOff;
 using Ampliar::BinaryHelper::isBitSet;
-using Ampliar::BinaryHelper::fromBcdToDecimal;
-using Ampliar::BinaryHelper::fromDecimalToBcd;
+using Ampliar::BinaryHelper::bcdToDecimal;
+using Ampliar::BinaryHelper::decimalToBcd;
 
 /**
  * Constructor.
  *
  * This constructor does not read any information from the device. Therefore, if you try to call any getter, it will
  * return the values initialized here (i.e., zero).
+ *
+ * @param device The device of the alarm (the default device, if omitted).
  */
-Alarm2::Alarm2():
-    BaseAlarm(RTC_REG_CONTROL_A2IE, RTC_REG_STATUS_A2F),
+Alarm2::Alarm2(Device& device):
+    BaseAlarm(device, RTC_REG_CONTROL_A2IE, RTC_REG_STATUS_A2F, RTC_ADDR_ALARM2, 3),
     _minute(0), _day(0), _hour(0), _dayOfWeek(0), _alarmRate(ALARM2_UNDEFINED)
 
 {
@@ -43,18 +45,45 @@ Alarm2::Alarm2():
  * object and make them available through getters, like getHour(), getMinute(), getAlarmRate(), etc.
  *
  * \b Note: you must call this method before using any getter, otherwise they will return zero or undefined.
+ *
+ * @return True if successful, or false if the I2C transfer failed (this object is left unchanged).
  */
-void Alarm2::readAlarm()
+bool Alarm2::readAlarm()
 {
-    Wire.beginTransmission(RTC_ADDR_I2C);
-    Wire.write(RTC_ADDR_ALARM2);
-    Wire.endTransmission();
+    uint8_t registers[3];
+    if (!readRegisters(RTC_ADDR_ALARM2, registers, 3))
+    {
+        return false;
+    }
+
+    decodeAlarm(registers);
+    return true;
+}
 
+/**
+ * Retrieves settings of the second alarm from a snapshot of the registers.
+ *
+ * This method works like readAlarm(), but it decodes the alarm from a snapshot previously read by
+ * BaseClock::readSnapshot(). Therefore, it does not communicate with the device.
+ *
+ * @param snapshot The snapshot of the registers.
+ */
+void Alarm2::readAlarm(const RegisterSnapshot& snapshot)
+{
+    decodeAlarm(snapshot.getRegisters(RTC_ADDR_ALARM2));
+}
+
+/**
+ * Decodes the alarm registers and stores the values in this object.
+ *
+ * @param registers The content of the 3 (three) alarm registers, starting at RTC_ADDR_ALARM2.
+ */
+void Alarm2::decodeAlarm(const uint8_t* registers)
+{
     //Gets raw data
-    Wire.requestFrom(RTC_ADDR_I2C, 3);
-    _minute    = Wire.read();
-    _hour      = Wire.read();
-    _day       = Wire.read();
+    _minute    = registers[0];
+    _hour      = registers[1];
+    _day       = registers[2];
 
     //Gets the flags used to determine the alarm rate
     bool a2m2        = isBitSet(_minute, RTC_ALARM2_A2M2);
@@ -91,9 +120,9 @@ void Alarm2::readAlarm()
     setBitOff(_day   , RTC_ALARM2_DYDT);
 
     //Gets the actual values
-    _minute = fromBcdToDecimal(_minute);
-    _hour   = fromBcdToDecimal(_hour);
-    _day    = fromBcdToDecimal(_day);
+    _minute = bcdToDecimal(_minute);
+    _hour   = bcdToDecimal(_hour);
+    _day    = bcdToDecimal(_day);
 
     /* This device uses the same place to store the the day of the month and the
      * day of the week. Therefore, we need to figure out what the value in _day is.
@@ -109,6 +138,37 @@ void Alarm2::readAlarm()
     }
 }
 
+/**
+ * Encodes the settings held by this object into the alarm registers.
+ *
+ * @param registers The buffer that will receive the 3 (three) alarm registers, starting at RTC_ADDR_ALARM2.
+ * @return          True if successful, or false if the alarm rate is undefined.
+ */
+bool Alarm2::encodeAlarm(uint8_t* registers) const
+{
+    if (_alarmRate == ALARM2_UNDEFINED)
+    {
+        return false;
+    }
+
+    registers[0] = decimalToBcd(_minute);
+    registers[1] = decimalToBcd(_hour);
+    registers[2] = decimalToBcd(_day);
+
+    if (_alarmRate == WHEN_MINUTES_AND_HOURS_AND_DAY_OF_WEEK_MATCH)
+    {
+        registers[2] = decimalToBcd(_dayOfWeek);
+        setBitOn(registers[2], RTC_ALARM2_DYDT);
+    }
+
+    //Each rate compares one more register, from the minutes up to the day; the others are masked (A2Mx set)
+    for (uint8_t i = _alarmRate - ONCE_PER_MINUTE; i < 3; i++)
+    {
+        registers[i] = 0x80;
+    }
+    return true;
+}
+
 /**
  * Set the alarm to trigger once per minute.
  *
@@ -121,18 +181,8 @@ void Alarm2::readAlarm()
  */
 void Alarm2::writeAlarmOncePerMinute()
 {
-    _minute    = 0;
-    _hour      = 0;
-    _day       = 0;
-    _dayOfWeek = 0;
-    _alarmRate = ONCE_PER_MINUTE;
-
-    Wire.beginTransmission(RTC_ADDR_I2C);
-    Wire.write(RTC_ADDR_ALARM2);
-    Wire.write(0x80); //A2M2
-    Wire.write(0x80); //A2M3
-    Wire.write(0x80); //A2M4
-    Wire.endTransmission();
+    setAlarm(ONCE_PER_MINUTE, 0, 0, 0, 0);
+    writeAlarmRegisters();
 }
 
 /**
@@ -151,20 +201,8 @@ void Alarm2::writeAlarmOncePerMinute()
  */
 void Alarm2::writeAlarm(uint8_t minute)
 {
-    _minute    = minute;
-    _hour      = 0;
-    _day       = 0;
-    _dayOfWeek = 0;
-    _alarmRate = WHEN_MINUTES_MATCH;
-
-    minute = fromDecimalToBcd(minute);
-
-    Wire.beginTransmission(RTC_ADDR_I2C);
-    Wire.write(RTC_ADDR_ALARM2);
-    Wire.write(minute); //A2M2
-    Wire.write(0x80);   //A2M3
-    Wire.write(0x80);   //A2M4
-    Wire.endTransmission();
+    setAlarm(WHEN_MINUTES_MATCH, 0, 0, 0, minute);
+    writeAlarmRegisters();
 }
 
 /**
@@ -184,21 +222,8 @@ void Alarm2::writeAlarm(uint8_t minute)
  */
 void Alarm2::writeAlarm(uint8_t hour, uint8_t minute)
 {
-    _minute    = minute;
-    _hour      = hour;
-    _day       = 0;
-    _dayOfWeek = 0;
-    _alarmRate = WHEN_MINUTES_AND_HOURS_MATCH;
-
-    hour   = fromDecimalToBcd(hour);
-    minute = fromDecimalToBcd(minute);
-
-    Wire.beginTransmission(RTC_ADDR_I2C);
-    Wire.write(RTC_ADDR_ALARM2);
-    Wire.write(minute); //A2M2
-    Wire.write(hour);   //A2M3
-    Wire.write(0x80);   //A2M4
-    Wire.endTransmission();
+    setAlarm(WHEN_MINUTES_AND_HOURS_MATCH, 0, 0, hour, minute);
+    writeAlarmRegisters();
 }
 
 /**
@@ -223,29 +248,101 @@ void Alarm2::writeAlarm(uint8_t hour, uint8_t minute)
  */
 void Alarm2::writeAlarm(bool useDayOfWeek, uint8_t day, uint8_t hour, uint8_t minute)
 {
-    _minute    = minute;
-    _hour      = hour;
-    _day       = useDayOfWeek ? 0            : day;
-    _dayOfWeek = useDayOfWeek ? useDayOfWeek : 0 ;
-    _alarmRate = useDayOfWeek
-               ? WHEN_MINUTES_AND_HOURS_AND_DAY_OF_WEEK_MATCH
-               : WHEN_MINUTES_AND_HOURS_AND_DAY_MATCH;
+    if (useDayOfWeek)
+    {
+        setAlarm(WHEN_MINUTES_AND_HOURS_AND_DAY_OF_WEEK_MATCH, 0, day, hour, minute);
+    }
+    else
+    {
+        setAlarm(WHEN_MINUTES_AND_HOURS_AND_DAY_MATCH, day, 0, hour, minute);
+    }
+    writeAlarmRegisters();
+}
 
-    minute = fromDecimalToBcd(minute);
-    hour   = fromDecimalToBcd(hour);
-    day    = fromDecimalToBcd(day);
+/**
+ * Sets the second alarm to trigger once per minute, turns it on and clears its flag in a single I2C transaction.
+ *
+ * @see writeAlarmOncePerMinute() and BaseAlarm::arm().
+ *
+ * @return True if successful or false, otherwise.
+ */
+bool Alarm2::armOncePerMinute()
+{
+    setAlarm(ONCE_PER_MINUTE, 0, 0, 0, 0);
+    return arm();
+}
 
+/**
+ * Sets the second alarm to trigger when minutes match, turns it on and clears its flag in a single I2C transaction.
+ *
+ * @see writeAlarm(uint8_t) and BaseAlarm::arm().
+ *
+ * @param minute The minutes (from 0 to 59).
+ * @return       True if successful or false, otherwise.
+ */
+bool Alarm2::arm(uint8_t minute)
+{
+    setAlarm(WHEN_MINUTES_MATCH, 0, 0, 0, minute);
+    return arm();
+}
+
+/**
+ * Sets the second alarm to trigger when hours and minutes match, turns it on and clears its flag in a single I2C
+ * transaction.
+ *
+ * @see writeAlarm(uint8_t, uint8_t) and BaseAlarm::arm().
+ *
+ * @param hour   The hours (from 0 to 23).
+ * @param minute The minutes (from 0 to 59).
+ * @return       True if successful or false, otherwise.
+ */
+bool Alarm2::arm(uint8_t hour, uint8_t minute)
+{
+    setAlarm(WHEN_MINUTES_AND_HOURS_MATCH, 0, 0, hour, minute);
+    return arm();
+}
+
+/**
+ * Sets the second alarm to trigger when the day (or day of week), hours and minutes match, turns it on and clears its
+ * flag in a single I2C transaction.
+ *
+ * @see writeAlarm(bool, uint8_t, uint8_t, uint8_t) and BaseAlarm::arm().
+ *
+ * @param useDayOfWeek Indicates if the parameter \b day must be interpreted as day of the week or day of the month.
+ * @param day          The day of the month (from 1 to 31) or the day of the week (from 1 to 7).
+ * @param hour         The hours (from 0 to 23).
+ * @param minute       The minutes (from 0 to 59).
+ * @return             True if successful or false, otherwise.
+ */
+bool Alarm2::arm(bool useDayOfWeek, uint8_t day, uint8_t hour, uint8_t minute)
+{
     if (useDayOfWeek)
     {
-        setBitOn(day, RTC_ALARM2_DYDT);
+        setAlarm(WHEN_MINUTES_AND_HOURS_AND_DAY_OF_WEEK_MATCH, 0, day, hour, minute);
+    }
+    else
+    {
+        setAlarm(WHEN_MINUTES_AND_HOURS_AND_DAY_MATCH, day, 0, hour, minute);
     }
+    return arm();
+}
 
-    Wire.beginTransmission(RTC_ADDR_I2C);
-    Wire.write(RTC_ADDR_ALARM2);
-    Wire.write(minute);  //A2M2
-    Wire.write(hour);    //A2M3
-    Wire.write(day);     //A2M4
-    Wire.endTransmission();
+/**
+ * Stores the settings of the alarm in this object, without writing them to the device.
+ *
+ * @param alarmRate The alarm rate.
+ * @param day       The day of the month (zero if not used).
+ * @param dayOfWeek The day of the week (zero if not used).
+ * @param hour      The hours.
+ * @param minute    The minutes.
+ */
+void Alarm2::setAlarm(AlarmRate alarmRate, uint8_t day, uint8_t dayOfWeek, uint8_t hour, uint8_t minute)
+{
+    _minute    = minute;
+    _hour      = hour;
+    _day       = day;
+    _dayOfWeek = dayOfWeek;
+    _alarmRate = alarmRate;
 }
 
 /**
@@ -17,7 +17,6 @@
 #define __AMPLIAR_DS3231_ALARM2_H__
 
 #include <stdint.h>
-#include <Wire.h>
 #include "BaseClock.h"
 #include "BinaryHelper.h"
 #include "BaseAlarm.h"
@@ -50,12 +49,18 @@ public:
     };
 
 public:
-    Alarm2();
-    void readAlarm();
+    explicit Alarm2(Device& device = BaseClock::getDefaultDevice());
+    bool readAlarm();
+    void readAlarm(const RegisterSnapshot& snapshot);
     void writeAlarmOncePerMinute();
     void writeAlarm(uint8_t minute);
     void writeAlarm(uint8_t hour, uint8_t minute);
     void writeAlarm(bool useDayOfWeek, uint8_t day, uint8_t hour, uint8_t minute);
+    using BaseAlarm::arm;
+    bool armOncePerMinute();
+    bool arm(uint8_t minute);
+    bool arm(uint8_t hour, uint8_t minute);
+    bool arm(bool useDayOfWeek, uint8_t day, uint8_t hour, uint8_t minute);
     uint8_t getMinute() const;
     uint8_t getHour() const;
     uint8_t getDay() const;
@@ -68,6 +73,9 @@ private:
     uint8_t _hour;
     uint8_t _dayOfWeek;
     AlarmRate _alarmRate;
+    void decodeAlarm(const uint8_t* registers);
+    bool encodeAlarm(uint8_t* registers) const;
+    void setAlarm(AlarmRate alarmRate, uint8_t day, uint8_t dayOfWeek, uint8_t hour, uint8_t minute);
 };
 
 }} //end of namespace
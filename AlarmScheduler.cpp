@@ -0,0 +1,351 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "AlarmScheduler.h"
+
+using namespace Ampliar::DS3231;
+
+/**
+ * Creates an empty scheduler. Call begin() before using it.
+ *
+ * @param device The device whose first alarm is used (the default device, if omitted).
+ */
+AlarmScheduler::AlarmScheduler(Device& device):
+    _alarm(device), _clock(device), _jobCount(0), _armedTime(0), _updating(false), _retrying(false)
+{
+    //
+}
+
+/**
+ * Turns on the first alarm and programs the nearest deadline, if any.
+ *
+ * @param enableInterruption If true, enables the hardware interruption output on the INT/SQW pin.
+ */
+void AlarmScheduler::begin(bool enableInterruption)
+{
+    _alarm.turnOn(enableInterruption);
+    update(true);
+}
+
+/**
+ * Schedules a job.
+ *
+ * If the job becomes the nearest one, the alarm is programmed again. If its deadline already passed, the callback is
+ * called at once (unless this method is called from a callback, in which case update() calls it before returning).
+ *
+ * @param deadline The Unix time when the job is due.
+ * @param callback The function called when the job is due.
+ * @param context  Argument passed to the callback.
+ * @return         True if the job was scheduled, or false if there are already RTC_SCHEDULER_CAPACITY jobs.
+ */
+bool AlarmScheduler::schedule(uint32_t deadline, JobCallback callback, void* context)
+{
+    if (_jobCount == RTC_SCHEDULER_CAPACITY)
+    {
+        return false;
+    }
+
+    uint8_t index = _jobCount++;
+    _jobs[index].deadline = deadline;
+    _jobs[index].callback = callback;
+    _jobs[index].context  = context;
+    if (siftUp(index) == 0 && !_updating)
+    {
+        update(true);
+    }
+    return true;
+}
+
+/**
+ * Schedules a job relative to the current time of the device.
+ *
+ * @param seconds  The number of seconds from now.
+ * @param callback The function called when the job is due.
+ * @param context  Argument passed to the callback.
+ * @return         True if the job was scheduled, or false if there are already RTC_SCHEDULER_CAPACITY jobs or the
+ *                 time could not be read.
+ */
+bool AlarmScheduler::scheduleIn(uint32_t seconds, JobCallback callback, void* context)
+{
+    if (!_clock.readDateTime())
+    {
+        return false;
+    }
+    return schedule(_clock.getUnixTime() + seconds, callback, context);
+}
+
+/**
+ * Cancels all jobs with the given callback and context.
+ *
+ * @param callback The function of the jobs.
+ * @param context  The argument of the jobs.
+ * @return         The number of jobs canceled.
+ */
+uint8_t AlarmScheduler::cancel(JobCallback callback, void* context)
+{
+    uint8_t canceled = 0;
+    uint8_t index    = 0;
+    while (index < _jobCount)
+    {
+        if (_jobs[index].callback == callback && _jobs[index].context == context)
+        {
+            removeAt(index);
+            canceled++;
+        }
+        else
+        {
+            index++;
+        }
+    }
+
+    if (canceled > 0 && !_updating)
+    {
+        update(true);
+    }
+    return canceled;
+}
+
+/**
+ * Calls the jobs due, if the alarm was triggered, and programs the next deadline.
+ *
+ * If the alarm was not triggered, this method only reads the status register.
+ *
+ * @return True if successful, or false if the time could not be read (see update(bool)).
+ */
+bool AlarmScheduler::update()
+{
+    return update(false);
+}
+
+/**
+ * Calls the jobs due and programs the next deadline.
+ *
+ * If the time cannot be read, no job is called and the alarm is left as it is. Since the alarm flag may already be
+ * cleared, the next call reads the time again, even if the alarm was not triggered.
+ *
+ * @param force If false, nothing is done unless the alarm was triggered. If true, the time is always read.
+ * @return      True if successful, or false if the time could not be read.
+ */
+bool AlarmScheduler::update(bool force)
+{
+    if (_updating)
+    {
+        return true;
+    }
+    //wasItTriggered() also clears the flag, which may be set even when forced
+    if (!_alarm.wasItTriggered() && !force && !_retrying)
+    {
+        return true;
+    }
+
+    //A failed read must not be taken as 1970, which would call every job and arm the alarm for a wrong time
+    if (!_clock.readDateTime())
+    {
+        _retrying = true;
+        return false;
+    }
+
+    _updating = true;
+    _retrying = false;
+    uint32_t now = _clock.getUnixTime();
+    for (;;)
+    {
+        while (_jobCount > 0 && _jobs[0].deadline <= now)
+        {
+            Job job = _jobs[0];
+            removeAt(0);
+            job.callback(job.deadline, job.context);
+        }
+
+        if (_jobCount == 0)
+        {
+            _armedTime = 0;
+            break;
+        }
+
+        armAt(_jobs[0].deadline, now);
+
+        //If the programmed time passed while the alarm was written, the match may have been missed
+        if (!_clock.readDateTime())
+        {
+            _retrying = true;
+            break;
+        }
+        now = _clock.getUnixTime();
+        if (now < _armedTime)
+        {
+            break;
+        }
+    }
+    _updating = false;
+    return !_retrying;
+}
+
+/**
+ * Programs the alarm to match the given deadline, or an intermediate time if it is too far.
+ *
+ * @param deadline The Unix time to be reached.
+ * @param now      The current Unix time (earlier than the deadline).
+ */
+void AlarmScheduler::armAt(uint32_t deadline, uint32_t now)
+{
+    //Up to one second before the same day and time next month, the date matches only once (the day of the deadline
+    //is either later this month or, next month, earlier than today)
+    uint32_t limit = Calendar::addMonths(now, 1) - 1;
+    if (deadline > limit)
+    {
+        deadline = limit;
+    }
+    uint32_t delta = deadline - now;
+
+    uint32_t secondsOfDay = Calendar::secondsOfDay(deadline);
+    uint16_t minutesOfDay = secondsOfDay / 60;
+    uint8_t second        = secondsOfDay % 60;
+    uint8_t minute        = minutesOfDay % 60;
+    uint8_t hour          = minutesOfDay / 60;
+
+    //The first match after now is at most one period (minute, hour, day or month) ahead
+    if (delta <= 60)
+    {
+        _alarm.writeAlarm(second);
+    }
+    else if (delta <= 3600)
+    {
+        _alarm.writeAlarm(minute, second);
+    }
+    else if (delta <= 86400)
+    {
+        _alarm.writeAlarm(hour, minute, second);
+    }
+    else
+    {
+        uint8_t day = Calendar::civilFromDays(Calendar::daysFromUnixTime(deadline)).day;
+        _alarm.writeAlarm(false, day, hour, minute, second);
+    }
+    _armedTime = deadline;
+}
+
+/**
+ * Gets the number of pending jobs.
+ *
+ * @return The number of jobs.
+ */
+uint8_t AlarmScheduler::getJobCount() const
+{
+    return _jobCount;
+}
+
+/**
+ * Gets the deadline of the nearest job.
+ *
+ * @return The Unix time of the nearest deadline, or 0 if there are no jobs.
+ */
+uint32_t AlarmScheduler::getNextDeadline() const
+{
+    return _jobCount > 0 ? _jobs[0].deadline : 0;
+}
+
+/**
+ * Gets the time programmed into the alarm, which is earlier than the nearest deadline if it is one calendar month
+ * ahead or more.
+ *
+ * @return The programmed Unix time, or 0 if there are no jobs.
+ */
+uint32_t AlarmScheduler::getArmedTime() const
+{
+    return _armedTime;
+}
+
+/**
+ * Removes a job from the heap.
+ *
+ * @param index The position of the job in the heap.
+ */
+void AlarmScheduler::removeAt(uint8_t index)
+{
+    _jobCount--;
+    if (index == _jobCount)
+    {
+        return;
+    }
+
+    _jobs[index] = _jobs[_jobCount];
+    siftDown(index);
+    siftUp(index);
+}
+
+/**
+ * Moves a job towards the root until its parent is not later.
+ *
+ * @param index The position of the job in the heap.
+ * @return      The new position of the job.
+ */
+uint8_t AlarmScheduler::siftUp(uint8_t index)
+{
+    while (index > 0)
+    {
+        uint8_t parent = (index - 1) / 2;
+        if (_jobs[parent].deadline <= _jobs[index].deadline)
+        {
+            break;
+        }
+        swap(parent, index);
+        index = parent;
+    }
+    return index;
+}
+
+/**
+ * Moves a job towards the leaves until none of its children is earlier.
+ *
+ * @param index The position of the job in the heap.
+ */
+void AlarmScheduler::siftDown(uint8_t index)
+{
+    for (;;)
+    {
+        //The children of the last positions are beyond 255
+        uint8_t earliest = index;
+        uint16_t left    = 2 * index + 1;
+        uint16_t right   = left + 1;
+        if (left < _jobCount && _jobs[left].deadline < _jobs[earliest].deadline)
+        {
+            earliest = (uint8_t)left;
+        }
+        if (right < _jobCount && _jobs[right].deadline < _jobs[earliest].deadline)
+        {
+            earliest = (uint8_t)right;
+        }
+        if (earliest == index)
+        {
+            break;
+        }
+        swap(earliest, index);
+        index = earliest;
+    }
+}
+
+/**
+ * Swaps two jobs of the heap.
+ *
+ * @param first  The position of a job.
+ * @param second The position of the other job.
+ */
+void AlarmScheduler::swap(uint8_t first, uint8_t second)
+{
+    Job job       = _jobs[first];
+    _jobs[first]  = _jobs[second];
+    _jobs[second] = job;
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_ALARM_SCHEDULER_H__
+#define __AMPLIAR_DS3231_ALARM_SCHEDULER_H__
+
+#include <stdint.h>
+#include "Calendar.h"
+#include "Alarm1.h"
+#include "RealTimeClock.h"
+
+namespace Ampliar { namespace DS3231 {
+
+#ifndef RTC_SCHEDULER_CAPACITY
+#define RTC_SCHEDULER_CAPACITY 16 ///< Maximum number of pending jobs, up to 255 (it can be defined beforehand)
+#endif
+
+/**
+ * Schedules many deadlines onto the first alarm of DS3231.
+ *
+ * The jobs are kept in a binary min-heap ordered by deadline (Unix time), and the nearest deadline is always programmed
+ * into Alarm1, with the mode that matches the fewest fields able to reach it without an earlier match:
+ *
+ * - seconds match, if the deadline is up to one minute ahead;
+ * - minutes and seconds match, if it is up to one hour ahead;
+ * - hours, minutes and seconds match, if it is up to one day ahead;
+ * - date, hours, minutes and seconds match, if it is less than one calendar month ahead (see Calendar::addMonths()).
+ *
+ * Farther deadlines are reached through intermediate wakeups, about one month apart.
+ *
+ * Call update() when the INT/SQW line is asserted (or periodically, if the line is not wired). Unless the alarm flag
+ * is set, update() costs a single register read. When it is set, update() reads the time, calls the callbacks of all
+ * jobs due, and programs the next deadline.
+ *
+ * The callbacks are called from update(), so they may schedule new jobs, including themselves for periodic jobs.
+ *
+ * @author Daniel Murari Boatto
+ */
+class AlarmScheduler
+{
+public:
+    /**
+     * Function called when a job is due.
+     */
+    typedef void (*JobCallback)(uint32_t deadline, void* context);
+
+public:
+    explicit AlarmScheduler(Device& device = BaseClock::getDefaultDevice());
+    void begin(bool enableInterruption = true);
+    bool schedule(uint32_t deadline, JobCallback callback, void* context);
+    bool scheduleIn(uint32_t seconds, JobCallback callback, void* context);
+    uint8_t cancel(JobCallback callback, void* context);
+    bool update();
+    bool update(bool force);
+    //
+    uint8_t getJobCount() const;
+    uint32_t getNextDeadline() const;
+    uint32_t getArmedTime() const;
+
+private:
+    /**
+     * A scheduled job.
+     */
+    struct Job
+    {
+        uint32_t deadline;
+        JobCallback callback;
+        void* context;
+    };
+
+    void armAt(uint32_t deadline, uint32_t now);
+    void removeAt(uint8_t index);
+    uint8_t siftUp(uint8_t index);
+    void siftDown(uint8_t index);
+    void swap(uint8_t first, uint8_t second);
+
+    /**
+     * Alarm that wakes the scheduler.
+     */
+    Alarm1 _alarm;
+
+    /**
+     * Clock used to read the time.
+     */
+    RealTimeClock _clock;
+
+    /**
+     * Binary min-heap of jobs, ordered by deadline.
+     */
+    Job _jobs[RTC_SCHEDULER_CAPACITY];
+
+    /**
+     * Number of jobs in the heap.
+     */
+    uint8_t _jobCount;
+
+    /**
+     * Time programmed into the alarm (zero if none).
+     */
+    uint32_t _armedTime;
+
+    /**
+     * True while update() calls the callbacks, so schedule() does not program the alarm in the middle of it.
+     */
+    bool _updating;
+
+    /**
+     * True if the last update() could not read the time, so the next one reads it even if the alarm was not triggered.
+     */
+    bool _retrying;
+};
+
+}} //end of namespace
+#endif //__AMPLIAR_DS3231_ALARM_SCHEDULER_H__
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "BaseAlarm.h"
+#include "Device.h"
 
 using namespace Ampliar::DS3231;
 using Ampliar::BinaryHelper::setBitOn;
@@ -24,10 +25,18 @@ using Ampliar::BinaryHelper::isBitSet;
  * Constructor.
  *
  * This constructor does not read any information from DS3231. It only performs member variables initialization.
+ *
+ * @param device The device of the alarm.
  */
-BaseAlarm::BaseAlarm(uint8_t alarmControlBit, uint8_t alarmStatusBit):
+BaseAlarm::BaseAlarm(Device& device, uint8_t alarmControlBit, uint8_t alarmStatusBit, uint8_t alarmAddress,
+                     uint8_t alarmLength):
+    BaseClock(device),
     _alarmControlBit(alarmControlBit),
-    _alarmStatusBit(alarmStatusBit)
+    _alarmStatusBit(alarmStatusBit),
+    _alarmAddress(alarmAddress),
+    _alarmLength(alarmLength),
+    _alarmCallback(0),
+    _callbackContext(0)
 {
     //
 }
@@ -49,14 +58,21 @@ BaseAlarm::~BaseAlarm()
  */
 bool BaseAlarm::isOn() const
 {
-    Wire.beginTransmission(RTC_ADDR_I2C);
-    Wire.write(RTC_ADDR_CONTROL);
-    Wire.endTransmission();
-
-    Wire.requestFrom(RTC_ADDR_I2C, 1);
-    uint8_t controlRegister = Wire.read();
+    return isBitSet(readCachedRegister(RTC_ADDR_CONTROL), _alarmControlBit);
+}
 
-    return isBitSet(controlRegister, _alarmControlBit);
+/**
+ * Checks whether the alarm is turned on or not, from a snapshot of the registers.
+ *
+ * This method works like isOn(), but it decodes the flag from a snapshot previously read by
+ * BaseClock::readSnapshot(). Therefore, it does not communicate with the device.
+ *
+ * @param snapshot The snapshot of the registers.
+ * @return         True if the alarm is active.
+ */
+bool BaseAlarm::isOn(const RegisterSnapshot& snapshot) const
+{
+    return isBitSet(snapshot.getRegister(RTC_ADDR_CONTROL), _alarmControlBit);
 }
 
 /**
@@ -64,10 +80,12 @@ bool BaseAlarm::isOn() const
  *
  * This method turns on the alarm and it does not change the status of the hardware interruption output on
  * INT/SQW pin.
+ *
+ * @return True if successful, or false if the I2C transfer failed.
  */
-void BaseAlarm::turnOn() const
+bool BaseAlarm::turnOn() const
 {
-    turnOn(false);
+    return turnOn(false);
 }
 
 /**
@@ -76,16 +94,21 @@ void BaseAlarm::turnOn() const
  * This method turns on the alarm and allows you to enable the hardware interruption output on INT/SQW pin.
  *
  * @param enableInterruption If true, enables the the hardware interruption output on the INT/SQW pin.
+ * @return                   True if successful, or false if the I2C transfer failed.
  */
-void BaseAlarm::turnOn(bool enableInterruption) const
+bool BaseAlarm::turnOn(bool enableInterruption) const
 {
-    uint8_t controlRegister = readRegister(RTC_ADDR_CONTROL);
+    uint8_t controlRegister;
+    if (!readCachedRegister(RTC_ADDR_CONTROL, controlRegister))
+    {
+        return false;
+    }
     if (enableInterruption)
     {
         setBitOn(controlRegister, RTC_REG_CONTROL_INTCN);
     }
     setBitOn(controlRegister, _alarmControlBit);
-    writeRegister(RTC_ADDR_CONTROL, controlRegister);
+    return writeRegister(RTC_ADDR_CONTROL, controlRegister);
 }
 
 /**
@@ -93,10 +116,12 @@ void BaseAlarm::turnOn(bool enableInterruption) const
  *
  * This method turns off the alarm and it does not change the status of the hardware interruption output on
  * INT/SQW pin.
+ *
+ * @return True if successful, or false if the I2C transfer failed.
  */
-void BaseAlarm::turnOff() const
+bool BaseAlarm::turnOff() const
 {
-    turnOff(false);
+    return turnOff(false);
 }
 
 /**
@@ -105,16 +130,21 @@ void BaseAlarm::turnOff() const
  * This method turns off the alarm and allows you to disable the hardware interruption output on INT/SQW pin.
  *
  * @param disableInterruption If true, disables the the hardware interruption output on the INT/SQW pin.
+ * @return                    True if successful, or false if the I2C transfer failed.
  */
-void BaseAlarm::turnOff(bool disableInterruption) const
+bool BaseAlarm::turnOff(bool disableInterruption) const
 {
-    uint8_t controlRegister = readRegister(RTC_ADDR_CONTROL);
+    uint8_t controlRegister;
+    if (!readCachedRegister(RTC_ADDR_CONTROL, controlRegister))
+    {
+        return false;
+    }
     setBitOff(controlRegister, _alarmControlBit);
     if (disableInterruption)
     {
         setBitOff(controlRegister, RTC_REG_CONTROL_INTCN);
     }
-    writeRegister(RTC_ADDR_CONTROL, controlRegister);
+    return writeRegister(RTC_ADDR_CONTROL, controlRegister);
 }
 
 /**
@@ -126,16 +156,21 @@ void BaseAlarm::turnOff(bool disableInterruption) const
  * If you don't want to call this method periodically to check the alarm status, you may choose to enable hardware
  * interruption when you turn on the alarm. Check the method turnOn() for more details.
  *
- * @return True if the alarm was triggered.
+ * @return True if the alarm was triggered, or false if it was not or the I2C transfer failed.
  */
 bool BaseAlarm::wasItTriggered() const
 {
-    uint8_t statusRegister = readRegister(RTC_ADDR_STATUS);
+    uint8_t statusRegister;
+    if (!readRegister(RTC_ADDR_STATUS, statusRegister))
+    {
+        return false;
+    }
     bool triggered = isBitSet(statusRegister, _alarmStatusBit);
 
-    //If it was triggered, it is necessary to reset it
+    //If it was triggered, it is necessary to reset it (the other flags are written as 1, which leaves them unchanged)
     if (triggered)
     {
+        statusRegister = (statusRegister & ~RTC_REG_STATUS_VOLATILE_MASK) | RTC_REG_STATUS_STICKY_MASK;
         setBitOff(statusRegister, _alarmStatusBit);
         writeRegister(RTC_ADDR_STATUS, statusRegister);
     }
@@ -145,10 +180,111 @@ bool BaseAlarm::wasItTriggered() const
 
 /**
  * Clears the flag used to indicate whether the alarm was triggered or not.
+ *
+ * If the shadow cache is enabled, this method costs a single I2C transaction. See BaseClock::enableShadowCache().
+ *
+ * @return True if successful, or false if the I2C transfer failed.
  */
-void BaseAlarm::clearAlarmFlag() const
+bool BaseAlarm::clearAlarmFlag() const
 {
-    uint8_t statusRegister = readRegister(RTC_ADDR_STATUS);
+    uint8_t statusRegister;
+    if (!readCachedRegister(RTC_ADDR_STATUS, statusRegister))
+    {
+        return false;
+    }
     setBitOff(statusRegister, _alarmStatusBit);
-    writeRegister(RTC_ADDR_STATUS, statusRegister);
+    return writeRegister(RTC_ADDR_STATUS, statusRegister);
+}
+
+/**
+ * Programs the alarm held by this object, turns it on and clears its flag, all in a single I2C transaction.
+ *
+ * The alarm, control and status registers are contiguous, so they are written in one auto-incrementing burst. There
+ * is no window in which the alarm is turned on with its old settings or with a stale flag. The registers between the
+ * alarm and the control register (the ones of the second alarm, when arming the first one) are written back unchanged.
+ *
+ * If the shadow cache is enabled and warm, this is the only I2C transaction. Otherwise, the registers written back
+ * unchanged are read first, in another single transaction.
+ *
+ * Like turnOn(), this method does not change the hardware interruption output on the INT/SQW pin.
+ *
+ * @return True if successful, or false if this object holds no valid alarm setting or the I2C transfer failed.
+ */
+bool BaseAlarm::arm() const
+{
+    //From the first register of the alarm up to the status register (at most 0x07 to 0x0F)
+    uint8_t registers[RTC_ADDR_STATUS - RTC_ADDR_ALARM1 + 1];
+    uint8_t length = RTC_ADDR_STATUS - _alarmAddress + 1;
+
+    if (!encodeAlarm(registers))
+    {
+        return false;
+    }
+    if (!readCachedRegisters(_alarmAddress + _alarmLength, registers + _alarmLength, length - _alarmLength))
+    {
+        return false;
+    }
+
+    //The other flags of the status register are returned as 1 (one), which leaves them unchanged
+    setBitOn(registers[RTC_ADDR_CONTROL - _alarmAddress], _alarmControlBit);
+    setBitOff(registers[RTC_ADDR_STATUS - _alarmAddress], _alarmStatusBit);
+
+    return writeRegisters(_alarmAddress, registers, length);
+}
+
+/**
+ * Writes the alarm held by this object to the alarm registers.
+ *
+ * @return True if successful, or false if this object holds no valid alarm setting or the I2C transfer failed.
+ */
+bool BaseAlarm::writeAlarmRegisters() const
+{
+    uint8_t registers[4];
+    if (!encodeAlarm(registers))
+    {
+        return false;
+    }
+    return writeRegisters(_alarmAddress, registers, _alarmLength);
+}
+
+/**
+ * Starts reading the settings of the alarm, without waiting for the I2C transfer.
+ *
+ * This method returns at once. Call the poll() of the device periodically (BaseClock::poll(), for the default
+ * device): when the transfer finishes, the settings are stored in this object (like readAlarm() does) and the
+ * callback is called from poll().
+ *
+ * Only one asynchronous read may be pending on each device (see Device::beginAsyncRead()).
+ *
+ * @param callback The function called when the read finishes.
+ * @param context  Argument passed to the callback.
+ * @return         True if the read was started, or false if another read is still pending.
+ */
+bool BaseAlarm::readAlarmAsync(AlarmCallback callback, void* context)
+{
+    if (getDevice().isReadPending())
+    {
+        return false;
+    }
+
+    _alarmCallback   = callback;
+    _callbackContext = context;
+    return beginAsyncRead(_alarmAddress, _alarmLength, onAlarmRead, this);
+}
+
+/**
+ * Completes an asynchronous alarm read.
+ *
+ * @param owner     The alarm that started the read.
+ * @param registers The content of the alarm registers.
+ * @param success   True if the registers were read.
+ */
+void BaseAlarm::onAlarmRead(BaseClock* owner, const uint8_t* registers, bool success)
+{
+    BaseAlarm* alarm = static_cast<BaseAlarm*>(owner);
+    if (success)
+    {
+        alarm->decodeAlarm(registers);
+    }
+    alarm->_alarmCallback(*alarm, success, alarm->_callbackContext);
 }
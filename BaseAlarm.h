@@ -17,8 +17,8 @@
 #define __AMPLIAR_DS3231_BASEALARM_H__
 
 #include <stdint.h>
-#include <Wire.h>
 #include "BaseClock.h"
+#include "RegisterSnapshot.h"
 #include "BinaryHelper.h"
 
 namespace Ampliar { namespace DS3231 {
@@ -32,21 +32,37 @@ namespace Ampliar { namespace DS3231 {
  */
 class BaseAlarm : public BaseClock
 {
+public:
+    /**
+     * Function called when an asynchronous alarm read finishes. The getters of the alarm hold the new values.
+     */
+    typedef void (*AlarmCallback)(const BaseAlarm& alarm, bool success, void* context);
+
 public:
     bool isOn() const;
-    void turnOn() const;
-    void turnOn(bool enableInterruption) const;
-    void turnOff() const;
-    void turnOff(bool disableInterruption) const;
+    bool isOn(const RegisterSnapshot& snapshot) const;
+    bool turnOn() const;
+    bool turnOn(bool enableInterruption) const;
+    bool turnOff() const;
+    bool turnOff(bool disableInterruption) const;
     bool wasItTriggered() const;
-    void clearAlarmFlag() const;
-    virtual void readAlarm() = 0;
+    bool clearAlarmFlag() const;
+    virtual bool readAlarm() = 0;
+    virtual void readAlarm(const RegisterSnapshot& snapshot) = 0;
+    bool readAlarmAsync(AlarmCallback callback, void* context);
+    bool arm() const;
 
 protected:
-    BaseAlarm(uint8_t alarmControlBit, uint8_t alarmStatusBit);
+    BaseAlarm(Device& device, uint8_t alarmControlBit, uint8_t alarmStatusBit, uint8_t alarmAddress,
+              uint8_t alarmLength);
     virtual ~BaseAlarm();
+    virtual void decodeAlarm(const uint8_t* registers) = 0;
+    virtual bool encodeAlarm(uint8_t* registers) const = 0;
+    bool writeAlarmRegisters() const;
 
 private:
+    static void onAlarmRead(BaseClock* owner, const uint8_t* registers, bool success);
+
     /**
      * Bit in the control register used to activate the alarm.
      */
@@ -56,6 +72,26 @@ private:
      * Bit in the status register used to figure out whether the alarm was triggered or not.
      */
     uint8_t _alarmStatusBit;
+
+    /**
+     * Address of the first register of the alarm.
+     */
+    uint8_t _alarmAddress;
+
+    /**
+     * Number of registers of the alarm.
+     */
+    uint8_t _alarmLength;
+
+    /**
+     * Function called when an asynchronous read finishes.
+     */
+    AlarmCallback _alarmCallback;
+
+    /**
+     * Argument passed to _alarmCallback.
+     */
+    void* _callbackContext;
 };
 
 }} //end of namespace
@@ -14,17 +14,79 @@
  * limitations under the License.
  */
 #include "BaseClock.h"
+#include "Device.h"
+#include "RegisterSnapshot.h"
+#include "WireTransport.h"
 
 using namespace Ampliar::DS3231;
 
+#if defined(ARDUINO)
+static WireTransport defaultTransport;
+Device BaseClock::_defaultDevice(defaultTransport);
+#else
+Device BaseClock::_defaultDevice;
+#endif
+
 /**
  * Constructor.
  *
  * This method setup I2C communication.
+ *
+ * @param device The device this object talks to. It must remain valid while this object exists.
+ */
+BaseClock::BaseClock(Device& device):
+    _device(&device)
+{
+    if (_device->getTransport())
+    {
+        _device->getTransport()->begin();
+    }
+}
+
+/**
+ * Sets the bus of the default device.
+ *
+ * On Arduino, the library uses WireTransport (the global Wire object) by default, so there is no need to call this
+ * method. On other platforms, there is no default bus and this method must be called before any communication with
+ * the default device.
+ *
+ * The default device is shared by all objects created without a Device.
+ *
+ * @param transport The bus transport. It must remain valid while it is in use.
  */
-BaseClock::BaseClock()
+void BaseClock::setTransport(BusTransport& transport)
 {
-    Wire.begin();
+    _defaultDevice.setTransport(transport);
+}
+
+/**
+ * Gets the bus of the default device.
+ *
+ * @return The bus transport, or null if none was set.
+ */
+BusTransport* BaseClock::getTransport()
+{
+    return _defaultDevice.getTransport();
+}
+
+/**
+ * Gets the device used by the objects created without one.
+ *
+ * @return The default device.
+ */
+Device& BaseClock::getDefaultDevice()
+{
+    return _defaultDevice;
+}
+
+/**
+ * Gets the device this object talks to.
+ *
+ * @return The device.
+ */
+Device& BaseClock::getDevice() const
+{
+    return *_device;
 }
 
 /**
@@ -38,13 +100,66 @@ BaseClock::BaseClock()
  * @param address The address of the register.
  * @return        The content of the register.
  */
-uint8_t BaseClock::readRegister(uint8_t address)
+uint8_t BaseClock::readRegister(uint8_t address) const
 {
-    Wire.beginTransmission(RTC_ADDR_I2C);
-    Wire.write(address);
-    Wire.endTransmission();
-    Wire.requestFrom(RTC_ADDR_I2C, 1);
-    return (uint8_t)Wire.read();
+    return _device->readRegister(address);
+}
+
+/**
+ * Reads one byte from a register at a given address, reporting whether the read succeeded.
+ *
+ * @see Device::readRegister().
+ *
+ * @param address The address of the register.
+ * @param value   The variable that receives the content of the register (unchanged if the read failed).
+ * @return        True if successful or false, otherwise.
+ */
+bool BaseClock::readRegister(uint8_t address, uint8_t& value) const
+{
+    return _device->readRegister(address, value);
+}
+
+/**
+ * Reads the configuration bits of a register, using the shadow cache when possible.
+ *
+ * @see Device::readCachedRegister().
+ *
+ * @param address The address of the register.
+ * @return        The content of the register.
+ */
+uint8_t BaseClock::readCachedRegister(uint8_t address) const
+{
+    return _device->readCachedRegister(address);
+}
+
+/**
+ * Reads the configuration bits of a register, using the shadow cache when possible, reporting whether the read
+ * succeeded.
+ *
+ * @see Device::readCachedRegister().
+ *
+ * @param address The address of the register.
+ * @param value   The variable that receives the content of the register (unchanged if the read failed).
+ * @return        True if successful or false, otherwise.
+ */
+bool BaseClock::readCachedRegister(uint8_t address, uint8_t& value) const
+{
+    return _device->readCachedRegister(address, value);
+}
+
+/**
+ * Reads the configuration bits of consecutive registers, using the shadow cache when possible.
+ *
+ * @see Device::readCachedRegisters().
+ *
+ * @param address The address of the first register.
+ * @param buffer  The buffer that will receive the content of the registers.
+ * @param length  The number of registers.
+ * @return        True if successful or false, otherwise.
+ */
+bool BaseClock::readCachedRegisters(uint8_t address, uint8_t* buffer, uint8_t length) const
+{
+    return _device->readCachedRegisters(address, buffer, length);
 }
 
 /**
@@ -57,11 +172,186 @@ uint8_t BaseClock::readRegister(uint8_t address)
  *
  * @param address The address of the register.
  * @param value   The value to be written in the register.
+ * @return        True if successful or false, otherwise.
+ */
+bool BaseClock::writeRegister(uint8_t address, uint8_t value) const
+{
+    return _device->writeRegister(address, value);
+}
+
+/**
+ * Reads consecutive registers in a single I2C transaction.
+ *
+ * @see Device::readRegisters().
+ *
+ * @param address The address of the first register.
+ * @param buffer  The buffer that will receive the content of the registers.
+ * @param length  The number of registers.
+ * @return        True if successful or false, otherwise.
+ */
+bool BaseClock::readRegisters(uint8_t address, uint8_t* buffer, uint8_t length) const
+{
+    return _device->readRegisters(address, buffer, length);
+}
+
+/**
+ * Writes consecutive registers in a single I2C transaction.
+ *
+ * @see Device::writeRegisters().
+ *
+ * @param address The address of the first register.
+ * @param buffer  The values to be written.
+ * @param length  The number of registers (up to RTC_SNAPSHOT_SIZE).
+ * @return        True if successful or false, otherwise.
+ */
+bool BaseClock::writeRegisters(uint8_t address, const uint8_t* buffer, uint8_t length) const
+{
+    return _device->writeRegisters(address, buffer, length);
+}
+
+/**
+ * Starts an asynchronous read of consecutive registers of the device of an object.
+ *
+ * Only one asynchronous read may be pending on each device (and on each bus, see BusTransport::beginWriteRead()). The
+ * handler is called by the poll() of the device when the read finishes, with the content of the registers.
+ *
+ * @param address The address of the first register.
+ * @param length  The number of registers (up to RTC_SNAPSHOT_SIZE).
+ * @param handler The function called when the read finishes.
+ * @param owner   The object passed to the handler.
+ * @return        True if the read was started, or false if another read is still pending.
+ */
+bool BaseClock::beginAsyncRead(uint8_t address, uint8_t length, AsyncHandler handler, BaseClock* owner)
+{
+    return owner->_device->beginAsyncRead(address, length, handler, owner);
+}
+
+/**
+ * Advances the pending asynchronous read of the default device.
+ *
+ * Call this method periodically (e.g., on every iteration of loop()) after starting an asynchronous read, like
+ * RealTimeClock::readDateTimeAsync(). When the read finishes, this method calls its completion callback. It never
+ * blocks. The reads of objects created with another device are advanced by that device (see Device::poll()).
+ *
+ * @return True if a read is still pending.
+ */
+bool BaseClock::poll()
+{
+    return _defaultDevice.poll();
+}
+
+/**
+ * Checks whether an asynchronous read of the default device is pending.
+ *
+ * @return True if a read is pending.
+ */
+bool BaseClock::isReadPending()
+{
+    return _defaultDevice.isReadPending();
+}
+
+/**
+ * Enables the shadow cache of the alarm, control, status and aging registers of the default device.
+ *
+ * When the shadow cache is enabled, this library keeps a copy of the configuration bits of the alarm (0x07 to 0x0D),
+ * control (0x0E), status (0x0F) and aging (0x10) registers. Every write goes to the device and to the copy
+ * (write-through), and every configuration change (like RealTimeClockController::enableSquareWave(),
+ * BaseAlarm::turnOn() or BaseAlarm::arm()) is done in a single I2C transaction, instead of a read followed by a write.
+ *
+ * Volatile bits (A1F, A2F, BSY, OSF and CONV) are never cached: methods that depend on them, like
+ * BaseAlarm::wasItTriggered() and RealTimeClock::wasItStopped(), always read the device.
+ *
+ * \b Note: If another I2C master (or another program) changes these registers, call invalidate() or refresh(),
+ * otherwise the next configuration change will overwrite its changes.
+ *
+ * Other devices have their own shadow cache (see Device::enableShadowCache()).
+ */
+void BaseClock::enableShadowCache()
+{
+    _defaultDevice.enableShadowCache();
+}
+
+/**
+ * Disables the shadow cache.
+ *
+ * After calling this method, every configuration change reads the register from the device before writing it.
+ *
+ * @see enableShadowCache().
+ */
+void BaseClock::disableShadowCache()
+{
+    _defaultDevice.disableShadowCache();
+}
+
+/**
+ * Checks whether the shadow cache is enabled or not.
+ *
+ * @return True if it is enabled.
+ */
+bool BaseClock::isShadowCacheEnabled()
+{
+    return _defaultDevice.isShadowCacheEnabled();
+}
+
+/**
+ * Discards the copy of the registers kept by the shadow cache.
+ *
+ * The next access to each register will read it from the device. Use this method when another I2C master may have
+ * changed the alarm, control, status or aging registers.
+ */
+void BaseClock::invalidate()
+{
+    _defaultDevice.invalidate();
+}
+
+/**
+ * Reloads the shadow cache from the device.
+ *
+ * This method reads the alarm, control, status and aging registers in a single I2C transaction and stores them in the
+ * shadow cache. It does nothing if the shadow cache is disabled.
+ */
+void BaseClock::refresh()
+{
+    _defaultDevice.refresh();
+}
+
+/**
+ * Reads the whole register file of the device.
+ *
+ * This method reads all registers (from 0x00 to 0x12) in a single I2C transaction. Date/time, alarms, control and
+ * status registers, aging offset and temperature can then be decoded from the snapshot without any further
+ * communication with the device. Since everything is read in one burst, all values refer to the same instant.
+ *
+ * If the shadow cache is enabled, it is refreshed as well.
+ *
+ * @param snapshot The object that will receive the content of the registers.
+ * @return         True if successful, or false if the I2C transfer failed (then, the snapshot must not be decoded).
+ */
+bool BaseClock::readSnapshot(RegisterSnapshot& snapshot)
+{
+    return _defaultDevice.readSnapshot(snapshot);
+}
+
+/**
+ * Reads the status register once and acknowledges the alarms that were triggered.
+ *
+ * This method replaces calls to BaseAlarm::wasItTriggered() of both alarms and to RealTimeClock::wasItStopped() in a
+ * main loop: it reads the status register in a single I2C transaction and, only if an alarm flag is set, clears the
+ * alarm flags in another one. Both alarms are seen at the same instant.
+ *
+ * An alarm triggered between the read and the write is not lost, since its flag is written as 1 (one), which leaves
+ * it unchanged. The oscillator stop flag is reported, but not cleared (see RealTimeClock::writeDateTime()). If the
+ * status register cannot be read, only RTC_EVENT_OSCILLATOR_STOPPED is reported.
+ *
+ * Example:
+ *
+ *     uint8_t events = BaseClock::pollEvents();
+ *     if (events & RTC_EVENT_ALARM1) { ... }
+ *     if (events & RTC_EVENT_ALARM2) { ... }
+ *
+ * @return A combination of RTC_EVENT_ALARM1, RTC_EVENT_ALARM2, RTC_EVENT_BUSY and RTC_EVENT_OSCILLATOR_STOPPED.
  */
-void BaseClock::writeRegister(uint8_t address, uint8_t value)
+uint8_t BaseClock::pollEvents()
 {
-    Wire.beginTransmission(RTC_ADDR_I2C);
-    Wire.write(address);
-    Wire.write(value);
-    Wire.endTransmission();
+    return _defaultDevice.pollEvents();
 }
@@ -17,10 +17,14 @@
 #define __AMPLIAR_DS3231_BASE_CLOCK_H__
 
 #include <stdint.h>
-#include <Wire.h>
+#include "Platform.h"
+#include "BusTransport.h"
 
 namespace Ampliar { namespace DS3231 {
 
+class RegisterSnapshot;
+class Device;
+
 #define RTC_ADDR_I2C         0x68 ///< DS3231 (Slave) Address
 #define RTC_ADDR_DATE        0x00 ///< Date/Time Register Address
 #define RTC_ADDR_ALARM1      0x07 ///< Alarm 1 Register Address
@@ -29,6 +33,7 @@ namespace Ampliar { namespace DS3231 {
 #define RTC_ADDR_STATUS      0x0F ///< Status Register Address
 #define RTC_ADDR_CONTROL     0x0E ///< Control Register Address
 #define RTC_ADDR_AGING       0x10 ///< Aging Register Address
+#define RTC_SNAPSHOT_SIZE    0x13 ///< Number of registers (from 0x00 to 0x12)
 
 #define RTC_REG_STATUS_A1F     0 ///< Alarm 1 Flag (A1F)
 #define RTC_REG_STATUS_A2F     1 ///< Alarm 2 Flag (A2F)
@@ -45,20 +50,80 @@ namespace Ampliar { namespace DS3231 {
 #define RTC_REG_CONTROL_BBSQW  6 ///< Battery-Backed Square-Wave Enable (BBSQW)
 #define RTC_REG_CONTROL_EOSC   7 ///< Enable Oscillator (EOSC)
 
+#define RTC_SHADOW_FIRST       RTC_ADDR_ALARM1  ///< First register kept in the shadow cache
+#define RTC_SHADOW_LAST        RTC_ADDR_AGING   ///< Last register kept in the shadow cache
+#define RTC_SHADOW_SIZE        (RTC_SHADOW_LAST - RTC_SHADOW_FIRST + 1) ///< Number of shadowed registers
+
+#define RTC_REG_STATUS_VOLATILE_MASK 0x87 ///< Status bits changed by the device itself (A1F, A2F, BSY and OSF)
+#define RTC_REG_STATUS_STICKY_MASK   0x83 ///< Status bits left unchanged when written to 1 (A1F, A2F and OSF)
+#define RTC_REG_CONTROL_VOLATILE_MASK 0x20 ///< Control bits changed by the device itself (CONV)
+
+#define RTC_EVENT_ALARM1             0x01 ///< Event returned by pollEvents(): the alarm 1 was triggered (A1F)
+#define RTC_EVENT_ALARM2             0x02 ///< Event returned by pollEvents(): the alarm 2 was triggered (A2F)
+#define RTC_EVENT_BUSY               0x04 ///< Event returned by pollEvents(): a conversion is in progress (BSY)
+#define RTC_EVENT_OSCILLATOR_STOPPED 0x80 ///< Event returned by pollEvents(): the oscillator was stopped (OSF)
+
 /**
  * Abstract class conceived to encapsulate low-level operations and configuration.
  *
  * This header file contains all registers addresses and flags bit-mapping of DS3231. Additionally, it contains methods
- * to abstract the I2C low-level operations to read and write registers.
+ * to abstract the I2C low-level operations to read and write registers. The I2C operations themselves are delegated
+ * to the Device of each object, which holds the bus, the multiplexer channel and the address of the DS3231. Objects
+ * created without a Device use the default device, whose bus is set with setTransport().
+ *
+ * Optionally, each device keeps a write-through shadow copy of the alarm, control, status and aging registers, so
+ * configuration changes do not need to read the register before writing it. See enableShadowCache() for details.
+ *
+ * Reads can also be asynchronous: subclasses start them with beginAsyncRead() and the application calls poll() from
+ * its main loop until the completion callback is called. Each device has its own pending read (see Device::poll()).
  *
  * @author Daniel Murari Boatto
  */
 class BaseClock
 {
+public:
+    /**
+     * Function called by poll() when an asynchronous read finishes.
+     */
+    typedef void (*AsyncHandler)(BaseClock* owner, const uint8_t* registers, bool success);
+
+public:
+    static void setTransport(BusTransport& transport);
+    static BusTransport* getTransport();
+    static Device& getDefaultDevice();
+    static void enableShadowCache();
+    static void disableShadowCache();
+    static bool isShadowCacheEnabled();
+    static void invalidate();
+    static void refresh();
+    static bool readSnapshot(RegisterSnapshot& snapshot);
+    static uint8_t pollEvents();
+    static bool poll();
+    static bool isReadPending();
+    Device& getDevice() const;
+
 protected:
-    BaseClock();
-    static uint8_t readRegister(uint8_t address);
-    static void writeRegister(uint8_t address, uint8_t value);
+    explicit BaseClock(Device& device);
+    uint8_t readRegister(uint8_t address) const;
+    bool readRegister(uint8_t address, uint8_t& value) const;
+    uint8_t readCachedRegister(uint8_t address) const;
+    bool readCachedRegister(uint8_t address, uint8_t& value) const;
+    bool readCachedRegisters(uint8_t address, uint8_t* buffer, uint8_t length) const;
+    bool writeRegister(uint8_t address, uint8_t value) const;
+    bool readRegisters(uint8_t address, uint8_t* buffer, uint8_t length) const;
+    bool writeRegisters(uint8_t address, const uint8_t* buffer, uint8_t length) const;
+    static bool beginAsyncRead(uint8_t address, uint8_t length, AsyncHandler handler, BaseClock* owner);
+
+private:
+    /**
+     * Device used by the objects created without one.
+     */
+    static Device _defaultDevice;
+
+    /**
+     * Device this object talks to.
+     */
+    Device* _device;
 };
 
 }} //end of namespace
@@ -17,32 +17,6 @@
 
 using namespace Ampliar;
 
-/**
- * Converts a base-10 integer to BCD.
- *
- * This method converts a base-10 integer to BCD (Binary-Coded Decimal).
- *
- * @param value Base-10 integer.
- * @return      BCD representation of the value.
- */
-int16_t BinaryHelper::fromDecimalToBcd(int16_t value)
-{
-    return (value / 10 * 16) + (value % 10);
-}
-
-/**
- * Converts a BCD value to a base-10 integer.
- *
- * This method converts a BCD (Binary-Coded Decimal) value to a base-10 integer.
- *
- * @param value BCD value.
- * @return      Base-10 integer.
- */
-int16_t BinaryHelper::fromBcdToDecimal(int16_t value)
-{
-    return (value / 16 * 10) + (value % 16);
-}
-
 /**
  * Turns on the bit at a specific position.
  *
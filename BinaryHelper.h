@@ -34,8 +34,64 @@ namespace BinaryHelper {
     void setBitOff(uint8_t& value, uint8_t bit);
     void toggleBit(uint8_t& value, uint8_t bit);
     bool isBitSet(uint8_t value, uint8_t bit);
-    int16_t fromDecimalToBcd(int16_t value);
-    int16_t fromBcdToDecimal(int16_t value);
+
+    /**
+     * Converts a base-10 integer (from 0 to 99) to BCD.
+     *
+     * The BCD representation is the value plus 6 (six) for each ten. The tens are calculated by multiplying by the
+     * reciprocal of 10 (103 / 1024 is exact from 0 to 178), so there is no division at run-time. Since this function
+     * is constexpr, constant arguments are converted at compile-time.
+     *
+     * @param value Base-10 integer (from 0 to 99).
+     * @return      BCD representation of the value.
+     */
+    constexpr uint8_t decimalToBcd(uint8_t value)
+    {
+        return value + (((value * 103) >> 10) * 6);
+    }
+
+    /**
+     * Converts a BCD value (from 0x00 to 0x99) to a base-10 integer.
+     *
+     * The tens digit is multiplied by 10 (ten) with shifts and additions, so there is no multiplication or division at
+     * run-time. Since this function is constexpr, constant arguments are converted at compile-time.
+     *
+     * @param value BCD value (from 0x00 to 0x99).
+     * @return      Base-10 integer.
+     */
+    constexpr uint8_t bcdToDecimal(uint8_t value)
+    {
+        return ((value >> 4) << 3) + ((value >> 4) << 1) + (value & 0x0F);
+    }
+
+    /**
+     * Converts a base-10 integer to BCD.
+     *
+     * Kept for compatibility. It is the same as decimalToBcd().
+     *
+     * @param value Base-10 integer (from 0 to 99).
+     * @return      BCD representation of the value.
+     */
+    inline int16_t fromDecimalToBcd(int16_t value)
+    {
+        return decimalToBcd((uint8_t)value);
+    }
+
+    /**
+     * Converts a BCD value to a base-10 integer.
+     *
+     * Kept for compatibility. It is the same as bcdToDecimal().
+     *
+     * @param value BCD value (from 0x00 to 0x99).
+     * @return      Base-10 integer.
+     */
+    inline int16_t fromBcdToDecimal(int16_t value)
+    {
+        return bcdToDecimal((uint8_t)value);
+    }
+
+    static_assert(decimalToBcd(59) == 0x59, "BCD encoding is broken");
+    static_assert(bcdToDecimal(0x99) == 99, "BCD decoding is broken");
 }
 
 } //end of namespace
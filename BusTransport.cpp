@@ -0,0 +1,73 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "BusTransport.h"
+
+using namespace Ampliar::DS3231;
+
+/**
+ * Virtual destructor, so transports can be destroyed through a pointer to this interface.
+ *
+ * Currently, this method is empty.
+ */
+BusTransport::~BusTransport()
+{
+    //
+}
+
+/**
+ * Starts a write followed by a read, without waiting for it to finish.
+ *
+ * The buffers must remain valid until poll() reports that the transaction finished.
+ *
+ * This default implementation executes the transaction at once, with writeRead(). Transports able to run the
+ * transaction in the background (e.g., driven by interrupts) should override this method and poll().
+ *
+ * @param address  The I2C address of the device.
+ * @param tx       The bytes to be written (usually the register address).
+ * @param txLength The number of bytes to be written.
+ * @param rx       The buffer that will receive the bytes read.
+ * @param rxLength The number of bytes to be read.
+ * @return         True if the transaction was started, or false if another one is still pending or its result was
+ *                 not collected by poll() yet.
+ */
+bool BusTransport::beginWriteRead(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength)
+{
+    if (_transferState != TRANSFER_IDLE)
+    {
+        return false;
+    }
+
+    _transferState = writeRead(address, tx, txLength, rx, rxLength) ? TRANSFER_DONE : TRANSFER_FAILED;
+    return true;
+}
+
+/**
+ * Checks the progress of the transaction started by beginWriteRead().
+ *
+ * TRANSFER_DONE or TRANSFER_FAILED is returned only once. After that, this method returns TRANSFER_IDLE until another
+ * transaction is started.
+ *
+ * @return The state of the transaction.
+ */
+BusTransport::TransferState BusTransport::poll()
+{
+    TransferState state = _transferState;
+    if (state != TRANSFER_PENDING)
+    {
+        _transferState = TRANSFER_IDLE;
+    }
+    return state;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_BUS_TRANSPORT_H__
+#define __AMPLIAR_DS3231_BUS_TRANSPORT_H__
+
+#include <stdint.h>
+
+namespace Ampliar { namespace DS3231 {
+
+/**
+ * Interface of the I2C bus used to communicate with DS3231.
+ *
+ * All classes of this library talk to the device through an implementation of this interface. By default, on Arduino,
+ * it is WireTransport, which uses the global Wire object. Other implementations (e.g., Linux i2c-dev or a simulated
+ * bus) can be installed with BaseClock::setTransport().
+ *
+ * Each method represents a complete I2C transaction, from START to STOP, so implementations can map them onto
+ * combined operations of their platform.
+ *
+ * Transports may also execute reads in the background: beginWriteRead() starts the transaction and returns at once,
+ * and poll() reports its progress. The default implementation of these methods simply calls writeRead(), so every
+ * transport supports the asynchronous API, even if it blocks.
+ *
+ * @author Daniel Murari Boatto
+ */
+class BusTransport
+{
+public:
+    /**
+     * State of an asynchronous transaction.
+     */
+    enum TransferState : uint8_t
+    {
+        TRANSFER_IDLE,    ///< No transaction was started
+        TRANSFER_PENDING, ///< The transaction is in progress
+        TRANSFER_DONE,    ///< The transaction finished successfully
+        TRANSFER_FAILED   ///< The transaction failed
+    };
+
+public:
+    constexpr BusTransport(): _transferState(TRANSFER_IDLE) {}
+    virtual ~BusTransport();
+    virtual void begin() = 0;
+    virtual bool write(uint8_t address, const uint8_t* data, uint8_t length) = 0;
+    virtual bool writeRead(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength) = 0;
+    virtual bool beginWriteRead(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength);
+    virtual TransferState poll();
+
+private:
+    /**
+     * State of the transaction started by the default implementation of beginWriteRead().
+     */
+    TransferState _transferState;
+};
+
+}} //end of namespace
+#endif //__AMPLIAR_DS3231_BUS_TRANSPORT_H__
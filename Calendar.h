@@ -0,0 +1,395 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_CALENDAR_H__
+#define __AMPLIAR_CALENDAR_H__
+
+#include <stdint.h>
+
+namespace Ampliar {
+
+/**
+ * Calendar functions namespace.
+ *
+ * These functions convert civil dates (proleptic Gregorian calendar) to and from a count of days since 1970-01-01,
+ * using the algorithms published by Howard Hinnant (http://howardhinnant.github.io/date_algorithms.html). They have no
+ * loops and only divide by constants, so they cost a few dozen cycles at run-time and, since they are constexpr, they
+ * cost nothing when their arguments are known at compile-time.
+ *
+ * They are written as single return statements, so they are also constexpr on C++11 compilers.
+ *
+ * @author Daniel Murari Boatto
+ */
+namespace Calendar {
+
+    /**
+     * A date of the proleptic Gregorian calendar.
+     */
+    struct CivilDate
+    {
+        int16_t year;  ///< The year with century (format yyyy).
+        uint8_t month; ///< The month (from 1 to 12).
+        uint8_t day;   ///< The day of the month (from 1 to 31).
+
+        constexpr CivilDate(int16_t year, uint8_t month, uint8_t day):
+            year(year), month(month), day(day)
+        {
+        }
+    };
+
+    namespace Detail {
+        // Day of the year, counted from March 1st (from 0 to 365).
+        constexpr uint16_t dayOfShiftedYear(uint8_t month, uint8_t day)
+        {
+            return (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+        }
+
+        // Era (period of 400 years) of a year counted from March 1st.
+        constexpr int32_t eraOfYear(int32_t year)
+        {
+            return (year >= 0 ? year : year - 399) / 400;
+        }
+
+        // Day of the era (from 0 to 146096) of a year of the era and a day of the year.
+        constexpr int32_t dayOfEra(int32_t yearOfEra, uint16_t dayOfYear)
+        {
+            return yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        }
+
+        constexpr int32_t daysFromShiftedYear(int32_t year, uint16_t dayOfYear)
+        {
+            return eraOfYear(year) * 146097 + dayOfEra(year - eraOfYear(year) * 400, dayOfYear) - 719468;
+        }
+
+        // Era of a day counted from 0000-03-01.
+        constexpr int32_t eraOfDay(int32_t days)
+        {
+            return (days >= 0 ? days : days - 146096) / 146097;
+        }
+
+        // Year of the era (from 0 to 399) of a day of the era.
+        constexpr int32_t yearOfEra(int32_t dayOfEra)
+        {
+            return (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        }
+
+        // Month, counted from March (from 0 to 11), of a day of the year counted from March 1st.
+        constexpr uint8_t shiftedMonth(int32_t dayOfYear)
+        {
+            return (5 * dayOfYear + 2) / 153;
+        }
+
+        constexpr CivilDate fromShiftedMonth(int32_t year, int32_t dayOfYear, uint8_t month)
+        {
+            return CivilDate(year + (month >= 10),
+                             month < 10 ? month + 3 : month - 9,
+                             dayOfYear - (153 * month + 2) / 5 + 1);
+        }
+
+        constexpr CivilDate fromDayOfYear(int32_t year, int32_t dayOfYear)
+        {
+            return fromShiftedMonth(year, dayOfYear, shiftedMonth(dayOfYear));
+        }
+
+        constexpr CivilDate fromYearOfEra(int32_t era, int32_t dayOfEra, int32_t yearOfEra)
+        {
+            return fromDayOfYear(era * 400 + yearOfEra,
+                                 dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100));
+        }
+
+        constexpr CivilDate fromDayOfEra(int32_t era, int32_t dayOfEra)
+        {
+            return fromYearOfEra(era, dayOfEra, yearOfEra(dayOfEra));
+        }
+
+        constexpr CivilDate fromShiftedDays(int32_t days)
+        {
+            return fromDayOfEra(eraOfDay(days), days - eraOfDay(days) * 146097);
+        }
+    }
+
+    /**
+     * Converts a civil date to the number of days since 1970-01-01.
+     *
+     * @param year  The year with century (format yyyy).
+     * @param month The month (from 1 to 12).
+     * @param day   The day of the month (from 1 to 31).
+     * @return      The number of days since 1970-01-01 (negative for earlier dates).
+     */
+    constexpr int32_t daysFromCivil(int16_t year, uint8_t month, uint8_t day)
+    {
+        return Detail::daysFromShiftedYear(year - (month <= 2), Detail::dayOfShiftedYear(month, day));
+    }
+
+    /**
+     * Converts a number of days since 1970-01-01 to a civil date.
+     *
+     * @param days The number of days since 1970-01-01 (negative for earlier dates).
+     * @return     The civil date.
+     */
+    constexpr CivilDate civilFromDays(int32_t days)
+    {
+        return Detail::fromShiftedDays(days + 719468);
+    }
+
+    /**
+     * Calculates the day of the week of a number of days since 1970-01-01.
+     *
+     * @param days The number of days since 1970-01-01 (negative for earlier dates).
+     * @return     The day of the week (from 0 to 6, where 0 is Sunday).
+     */
+    constexpr uint8_t weekdayFromDays(int32_t days)
+    {
+        return days >= -4 ? (days + 4) % 7 : (days + 5) % 7 + 6;
+    }
+
+    /**
+     * Converts a civil date and time to Unix time.
+     *
+     * @param year   The year with century (from 1970 to 2106).
+     * @param month  The month (from 1 to 12).
+     * @param day    The day of the month (from 1 to 31).
+     * @param hour   The hours (from 0 to 23).
+     * @param minute The minutes (from 0 to 59).
+     * @param second The seconds (from 0 to 59).
+     * @return       The number of seconds since 1970-01-01 00:00:00.
+     */
+    constexpr uint32_t toUnixTime(int16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute,
+                                  uint8_t second)
+    {
+        return (uint32_t)daysFromCivil(year, month, day) * 86400UL + hour * 3600UL + minute * 60U + second;
+    }
+
+    /**
+     * Gets the number of days since 1970-01-01 of a Unix time.
+     *
+     * @param time The number of seconds since 1970-01-01 00:00:00.
+     * @return     The number of days.
+     */
+    constexpr int32_t daysFromUnixTime(uint32_t time)
+    {
+        return time / 86400UL;
+    }
+
+    /**
+     * Gets the number of seconds since midnight of a Unix time.
+     *
+     * @param time The number of seconds since 1970-01-01 00:00:00.
+     * @return     The number of seconds since midnight (from 0 to 86399).
+     */
+    constexpr uint32_t secondsOfDay(uint32_t time)
+    {
+        return time % 86400UL;
+    }
+
+    /**
+     * Checks whether a year is a leap year (divisible by 4, except centuries not divisible by 400).
+     *
+     * @param year The year with century (format yyyy).
+     * @return     True if February has 29 days in that year.
+     */
+    constexpr bool isLeapYear(int16_t year)
+    {
+        return (year % 4 == 0) & ((year % 100 != 0) | (year % 400 == 0));
+    }
+
+    /**
+     * Gets the number of days of a month.
+     *
+     * @param year  The year with century (format yyyy).
+     * @param month The month (from 1 to 12).
+     * @return      The number of days (from 28 to 31).
+     */
+    constexpr uint8_t daysInMonth(int16_t year, uint8_t month)
+    {
+        //From August on, the months of 31 days are the even ones
+        return month == 2 ? 28 + isLeapYear(year) : 30 + ((month ^ (month >> 3)) & 1);
+    }
+
+    /**
+     * Gets the day of the year of a civil date.
+     *
+     * @param year  The year with century (format yyyy).
+     * @param month The month (from 1 to 12).
+     * @param day   The day of the month (from 1 to 31).
+     * @return      The day of the year (from 1 to 366).
+     */
+    constexpr uint16_t dayOfYear(int16_t year, uint8_t month, uint8_t day)
+    {
+        return daysFromCivil(year, month, day) - daysFromCivil(year, 1, 1) + 1;
+    }
+
+    /**
+     * Calculates the day of the week of a civil date.
+     *
+     * @param year  The year with century (format yyyy).
+     * @param month The month (from 1 to 12).
+     * @param day   The day of the month (from 1 to 31).
+     * @return      The day of the week (from 0 to 6, where 0 is Sunday).
+     */
+    constexpr uint8_t weekday(int16_t year, uint8_t month, uint8_t day)
+    {
+        return weekdayFromDays(daysFromCivil(year, month, day));
+    }
+
+    namespace Detail {
+        // Thursday of the ISO week (Monday to Sunday) of a day, which gives the ISO year of the week.
+        constexpr int32_t isoThursday(int32_t days)
+        {
+            return days - (weekdayFromDays(days) + 6) % 7 + 3;
+        }
+
+        constexpr uint8_t isoWeekOfThursday(int32_t thursday, int16_t isoYear)
+        {
+            return (thursday - daysFromCivil(isoYear, 1, 1)) / 7 + 1;
+        }
+
+        // Unix time of a month counted from year 0 (year * 12 + month - 1), a day limited to its length and a time.
+        constexpr uint32_t fromMonthIndex(int32_t monthIndex, uint8_t day, uint32_t secondsOfDay)
+        {
+            return (uint32_t)daysFromCivil(monthIndex / 12, monthIndex % 12 + 1,
+                                           day < daysInMonth(monthIndex / 12, monthIndex % 12 + 1)
+                                               ? day : daysInMonth(monthIndex / 12, monthIndex % 12 + 1))
+                   * 86400UL + secondsOfDay;
+        }
+
+        constexpr uint32_t addMonthsToDate(CivilDate date, int32_t months, uint32_t secondsOfDay)
+        {
+            return fromMonthIndex(date.year * 12L + date.month - 1 + months, date.day, secondsOfDay);
+        }
+    }
+
+    /**
+     * Gets the year of the ISO 8601 week of a civil date, which differs from the year in the first and last days of
+     * some years (e.g., 2021-01-01 belongs to the week 53 of 2020).
+     *
+     * @param year  The year with century (format yyyy).
+     * @param month The month (from 1 to 12).
+     * @param day   The day of the month (from 1 to 31).
+     * @return      The ISO year of the week.
+     */
+    constexpr int16_t isoWeekYear(int16_t year, uint8_t month, uint8_t day)
+    {
+        return civilFromDays(Detail::isoThursday(daysFromCivil(year, month, day))).year;
+    }
+
+    /**
+     * Gets the ISO 8601 week of a civil date. Weeks start on Monday and the first week of a year is the one with its
+     * first Thursday.
+     *
+     * @param year  The year with century (format yyyy).
+     * @param month The month (from 1 to 12).
+     * @param day   The day of the month (from 1 to 31).
+     * @return      The week (from 1 to 53) of the year returned by isoWeekYear().
+     */
+    constexpr uint8_t isoWeek(int16_t year, uint8_t month, uint8_t day)
+    {
+        return Detail::isoWeekOfThursday(Detail::isoThursday(daysFromCivil(year, month, day)),
+                                         isoWeekYear(year, month, day));
+    }
+
+    /**
+     * Adds a number of seconds to a Unix time.
+     *
+     * @param time    The number of seconds since 1970-01-01 00:00:00.
+     * @param seconds The number of seconds to add (negative to subtract).
+     * @return        The resulting Unix time.
+     */
+    constexpr uint32_t addSeconds(uint32_t time, int32_t seconds)
+    {
+        return time + (uint32_t)seconds;
+    }
+
+    /**
+     * Adds a number of days to a Unix time. The time of the day is kept.
+     *
+     * @param time The number of seconds since 1970-01-01 00:00:00.
+     * @param days The number of days to add (negative to subtract).
+     * @return     The resulting Unix time.
+     */
+    constexpr uint32_t addDays(uint32_t time, int32_t days)
+    {
+        return time + (uint32_t)days * 86400UL;
+    }
+
+    /**
+     * Adds a number of months to a Unix time. The time of the day is kept, and the day of the month is limited to the
+     * length of the resulting month (e.g., one month after January 31st is February 28th or 29th).
+     *
+     * @param time   The number of seconds since 1970-01-01 00:00:00.
+     * @param months The number of months to add (negative to subtract).
+     * @return       The resulting Unix time.
+     */
+    constexpr uint32_t addMonths(uint32_t time, int32_t months)
+    {
+        return Detail::addMonthsToDate(civilFromDays(daysFromUnixTime(time)), months, secondsOfDay(time));
+    }
+
+    /**
+     * Adds a number of years to a Unix time, like addMonths() does (February 29th becomes February 28th).
+     *
+     * @param time  The number of seconds since 1970-01-01 00:00:00.
+     * @param years The number of years to add (negative to subtract).
+     * @return      The resulting Unix time.
+     */
+    constexpr uint32_t addYears(uint32_t time, int16_t years)
+    {
+        return addMonths(time, years * 12L);
+    }
+
+    /**
+     * Calculates the number of seconds between two Unix times.
+     *
+     * @param from The earlier Unix time.
+     * @param to   The later Unix time.
+     * @return     The number of seconds from the first to the second (negative if the second is earlier).
+     */
+    constexpr int32_t secondsBetween(uint32_t from, uint32_t to)
+    {
+        return (int32_t)(to - from);
+    }
+
+    /**
+     * Calculates the number of midnights between two Unix times (i.e., the difference of their dates).
+     *
+     * @param from The earlier Unix time.
+     * @param to   The later Unix time.
+     * @return     The number of days from the date of the first to the date of the second (negative if the second is
+     *             earlier).
+     */
+    constexpr int32_t daysBetween(uint32_t from, uint32_t to)
+    {
+        return daysFromUnixTime(to) - daysFromUnixTime(from);
+    }
+
+    static_assert(daysFromCivil(1970, 1, 1) == 0, "Unix epoch must be day zero");
+    static_assert(daysFromCivil(2000, 3, 1) == 11017, "2000 is a leap year");
+    static_assert(civilFromDays(11016).day == 29, "2000-02-29 must exist");
+    static_assert(weekdayFromDays(0) == 4, "1970-01-01 was a Thursday");
+    static_assert(isLeapYear(2000) && !isLeapYear(2100) && isLeapYear(2024), "Leap years");
+    static_assert(daysInMonth(2023, 2) == 28 && daysInMonth(2024, 2) == 29 && daysInMonth(2024, 7) == 31
+                  && daysInMonth(2024, 8) == 31 && daysInMonth(2024, 9) == 30 && daysInMonth(2024, 12) == 31,
+                  "Lengths of the months");
+    static_assert(dayOfYear(2024, 12, 31) == 366, "2024 has 366 days");
+    static_assert(isoWeek(2021, 1, 1) == 53 && isoWeekYear(2021, 1, 1) == 2020, "2021-01-01 is in 2020-W53");
+    static_assert(isoWeek(2024, 12, 30) == 1 && isoWeekYear(2024, 12, 30) == 2025, "2024-12-30 is in 2025-W01");
+    static_assert(addMonths(toUnixTime(2024, 1, 31, 12, 0, 0), 1) == toUnixTime(2024, 2, 29, 12, 0, 0),
+                  "One month after January 31st is the last day of February");
+    static_assert(addMonths(toUnixTime(2024, 3, 15, 0, 0, 0), -15) == toUnixTime(2022, 12, 15, 0, 0, 0),
+                  "Months can be subtracted across years");
+}
+
+} //end of namespace
+#endif //__AMPLIAR_CALENDAR_H__
@@ -0,0 +1,178 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CountingTransport.h"
+
+using namespace Ampliar::DS3231;
+
+/**
+ * Constructor.
+ *
+ * @param transport The transport whose traffic will be measured. It must remain valid while this object exists.
+ */
+CountingTransport::CountingTransport(BusTransport& transport):
+    _transport(transport), _transactions(0), _bytes(0), _starts(0), _stops(0)
+{
+    //
+}
+
+/**
+ * Setups the measured transport.
+ */
+void CountingTransport::begin()
+{
+    _transport.begin();
+}
+
+/**
+ * Writes bytes to a device and counts the traffic.
+ *
+ * @param address The I2C address of the device.
+ * @param data    The bytes to be written.
+ * @param length  The number of bytes.
+ * @return        The result of the measured transport.
+ */
+bool CountingTransport::write(uint8_t address, const uint8_t* data, uint8_t length)
+{
+    _transactions++;
+    _starts++;
+    _stops++;
+    _bytes += 1 + length;
+
+    return _transport.write(address, data, length);
+}
+
+/**
+ * Writes bytes to a device, reads its answer and counts the traffic.
+ *
+ * @param address  The I2C address of the device.
+ * @param tx       The bytes to be written.
+ * @param txLength The number of bytes to be written.
+ * @param rx       The buffer that will receive the bytes read.
+ * @param rxLength The number of bytes to be read.
+ * @return         The result of the measured transport.
+ */
+bool CountingTransport::writeRead(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength)
+{
+    _transactions++;
+    _starts += 2;
+    _stops++;
+    _bytes += 1 + txLength + 1 + rxLength;
+
+    return _transport.writeRead(address, tx, txLength, rx, rxLength);
+}
+
+/**
+ * Counts and starts an asynchronous write followed by a read in the decorated transport.
+ *
+ * The transaction is counted like writeRead(), when it is started.
+ *
+ * @param address  The I2C address of the device.
+ * @param tx       The bytes to be written.
+ * @param txLength The number of bytes to be written.
+ * @param rx       The buffer that will receive the bytes read.
+ * @param rxLength The number of bytes to be read.
+ * @return         True if the transaction was started.
+ */
+bool CountingTransport::beginWriteRead(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx,
+                                       uint8_t rxLength)
+{
+    if (!_transport.beginWriteRead(address, tx, txLength, rx, rxLength))
+    {
+        return false;
+    }
+
+    _transactions++;
+    _starts += 2;
+    _stops++;
+    _bytes += 1 + txLength + 1 + rxLength;
+    return true;
+}
+
+/**
+ * Checks the progress of the asynchronous transaction of the decorated transport.
+ *
+ * @return The state of the transaction.
+ */
+BusTransport::TransferState CountingTransport::poll()
+{
+    return _transport.poll();
+}
+
+/**
+ * Resets all counters.
+ */
+void CountingTransport::reset()
+{
+    _transactions = 0;
+    _bytes        = 0;
+    _starts       = 0;
+    _stops        = 0;
+}
+
+/**
+ * Gets the number of transactions since the last reset.
+ *
+ * @return The number of transactions.
+ */
+uint32_t CountingTransport::getTransactions() const
+{
+    return _transactions;
+}
+
+/**
+ * Gets the number of bytes on the wire since the last reset, including the address bytes.
+ *
+ * @return The number of bytes.
+ */
+uint32_t CountingTransport::getBytes() const
+{
+    return _bytes;
+}
+
+/**
+ * Gets the number of START conditions since the last reset, including repeated STARTs.
+ *
+ * @return The number of START conditions.
+ */
+uint32_t CountingTransport::getStarts() const
+{
+    return _starts;
+}
+
+/**
+ * Gets the number of STOP conditions since the last reset.
+ *
+ * @return The number of STOP conditions.
+ */
+uint32_t CountingTransport::getStops() const
+{
+    return _stops;
+}
+
+/**
+ * Estimates how long the bus was busy since the last reset.
+ *
+ * Each byte takes 9 (nine) clock cycles (8 bits and the acknowledge bit) and each START or STOP condition is counted
+ * as one clock cycle. Clock stretching and the time between transactions are not considered.
+ *
+ * @param frequency The I2C clock frequency, in Hz (e.g., 100000 or 400000).
+ * @return          The estimated bus time, in microseconds.
+ */
+uint32_t CountingTransport::getBusTimeMicros(uint32_t frequency) const
+{
+    uint64_t cycles = (uint64_t)_bytes * 9 + _starts + _stops;
+    return (uint32_t)((cycles * 1000000 + frequency - 1) / frequency);
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_COUNTING_TRANSPORT_H__
+#define __AMPLIAR_DS3231_COUNTING_TRANSPORT_H__
+
+#include <stdint.h>
+#include "BusTransport.h"
+
+namespace Ampliar { namespace DS3231 {
+
+/**
+ * Bus transport that measures the I2C traffic of another transport.
+ *
+ * This class forwards every transaction to another transport (like WireTransport or Simulator) and counts
+ * transactions, bytes on the wire (including the address bytes) and START/STOP conditions. It also estimates how long
+ * the bus was busy at a given clock frequency.
+ *
+ * A write is counted as START, address, data and STOP. A write followed by a read is counted as START, address, data,
+ * repeated START, address, data and STOP.
+ *
+ * @author Daniel Murari Boatto
+ */
+class CountingTransport : public BusTransport
+{
+public:
+    explicit CountingTransport(BusTransport& transport);
+    void begin();
+    bool write(uint8_t address, const uint8_t* data, uint8_t length);
+    bool writeRead(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength);
+    bool beginWriteRead(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength);
+    TransferState poll();
+    //
+    void reset();
+    uint32_t getTransactions() const;
+    uint32_t getBytes() const;
+    uint32_t getStarts() const;
+    uint32_t getStops() const;
+    uint32_t getBusTimeMicros(uint32_t frequency) const;
+
+private:
+    /**
+     * Transport that actually executes the transactions.
+     */
+    BusTransport& _transport;
+
+    /**
+     * Number of transactions.
+     */
+    uint32_t _transactions;
+
+    /**
+     * Number of bytes on the wire, including address bytes.
+     */
+    uint32_t _bytes;
+
+    /**
+     * Number of START conditions, including repeated STARTs.
+     */
+    uint32_t _starts;
+
+    /**
+     * Number of STOP conditions.
+     */
+    uint32_t _stops;
+};
+
+}} //end of namespace
+#endif //__AMPLIAR_DS3231_COUNTING_TRANSPORT_H__
@@ -0,0 +1,385 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CronSchedule.h"
+
+using namespace Ampliar::DS3231;
+
+/**
+ * Creates a schedule that never matches. Call parse() before using it.
+ */
+CronSchedule::CronSchedule():
+    _minutes(0), _hours(0), _days(0), _months(0), _daysOfWeek(0), _daysRestricted(false),
+    _daysOfWeekRestricted(false), _alarmRate(Alarm2::ALARM2_UNDEFINED), _residual(false)
+{
+    //
+}
+
+/**
+ * Parses a cron expression and chooses the alarm rate.
+ *
+ * @param expression The cron expression (see the description of this class).
+ * @return           True if successful, or false if the expression is invalid (the schedule is then left unchanged).
+ */
+bool CronSchedule::parse(const char* expression)
+{
+    static const char* const shortcuts[][2] = {
+        { "@yearly",   "0 0 1 1 *" },
+        { "@annually", "0 0 1 1 *" },
+        { "@monthly",  "0 0 1 * *" },
+        { "@weekly",   "0 0 * * 0" },
+        { "@daily",    "0 0 * * *" },
+        { "@midnight", "0 0 * * *" },
+        { "@hourly",   "0 * * * *" }
+    };
+
+    for (uint8_t i = 0; i < sizeof(shortcuts) / sizeof(shortcuts[0]); i++)
+    {
+        const char* name = shortcuts[i][0];
+        const char* text = expression;
+        while (*name != '\0' && *name == *text)
+        {
+            name++;
+            text++;
+        }
+        if (*name == '\0' && *text == '\0')
+        {
+            expression = shortcuts[i][1];
+            break;
+        }
+    }
+
+    uint64_t minutes, hours, days, months, daysOfWeek;
+    bool restricted, daysRestricted, daysOfWeekRestricted;
+    const char* cursor = expression;
+
+    if (!parseField(cursor, 0, 59, minutes,    restricted)           ||
+        !parseField(cursor, 0, 23, hours,      restricted)           ||
+        !parseField(cursor, 1, 31, days,       daysRestricted)       ||
+        !parseField(cursor, 1, 12, months,     restricted)           ||
+        !parseField(cursor, 0, 7,  daysOfWeek, daysOfWeekRestricted) ||
+        *cursor != '\0')
+    {
+        return false;
+    }
+
+    _minutes              = minutes;
+    _hours                = hours;
+    _days                 = days;
+    _months               = months;
+    _daysOfWeek           = (daysOfWeek | (daysOfWeek >> 7)) & 0x7F; //7 is also Sunday
+    _daysRestricted       = daysRestricted;
+    _daysOfWeekRestricted = daysOfWeekRestricted;
+    compile();
+    return true;
+}
+
+/**
+ * Chooses the alarm rate with the fewest wakeups and whether a residual predicate is needed.
+ */
+void CronSchedule::compile()
+{
+    const uint64_t allMinutes = 0x0FFFFFFFFFFFFFFFULL;
+    const uint32_t allHours   = 0x00FFFFFFUL;
+    const uint32_t allDays    = 0xFFFFFFFEUL;
+    const uint16_t allMonths  = 0x1FFE;
+
+    //The fields are compared by their bit sets, since a step ("*/2") is not restricted but does not match every day
+    bool eitherDay = _daysRestricted && _daysOfWeekRestricted;
+    bool anyDay    = eitherDay ? _days == allDays || _daysOfWeek == 0x7F : _days == allDays && _daysOfWeek == 0x7F;
+
+    if (countBits(_minutes) != 1)
+    {
+        _alarmRate = Alarm2::ONCE_PER_MINUTE;
+        _residual  = _minutes != allMinutes || _hours != allHours || !anyDay || _months != allMonths;
+    }
+    else if (countBits(_hours) != 1)
+    {
+        _alarmRate = Alarm2::WHEN_MINUTES_MATCH;
+        _residual  = _hours != allHours || !anyDay || _months != allMonths;
+    }
+    else if (!eitherDay && countBits(_days) == 1)
+    {
+        _alarmRate = Alarm2::WHEN_MINUTES_AND_HOURS_AND_DAY_MATCH;
+        _residual  = _daysOfWeek != 0x7F || _months != allMonths;
+    }
+    else if (!eitherDay && countBits(_daysOfWeek) == 1)
+    {
+        _alarmRate = Alarm2::WHEN_MINUTES_AND_HOURS_AND_DAY_OF_WEEK_MATCH;
+        _residual  = _days != allDays || _months != allMonths;
+    }
+    else
+    {
+        _alarmRate = Alarm2::WHEN_MINUTES_AND_HOURS_MATCH;
+        _residual  = !anyDay || _months != allMonths;
+    }
+}
+
+/**
+ * Programs the alarm with the rate chosen by parse().
+ *
+ * The day of the week is written the way RealTimeClock::writeDateTime() numbers it (1 is Sunday).
+ *
+ * @param alarm The second alarm.
+ */
+void CronSchedule::writeAlarm(Alarm2& alarm) const
+{
+    if (_alarmRate == Alarm2::ALARM2_UNDEFINED)
+    {
+        return;
+    }
+
+    uint8_t minute = lowestBit(_minutes);
+    uint8_t hour   = lowestBit(_hours);
+
+    switch (_alarmRate)
+    {
+        case Alarm2::ONCE_PER_MINUTE:
+            alarm.writeAlarmOncePerMinute();
+            break;
+        case Alarm2::WHEN_MINUTES_MATCH:
+            alarm.writeAlarm(minute);
+            break;
+        case Alarm2::WHEN_MINUTES_AND_HOURS_MATCH:
+            alarm.writeAlarm(hour, minute);
+            break;
+        case Alarm2::WHEN_MINUTES_AND_HOURS_AND_DAY_MATCH:
+            alarm.writeAlarm(false, lowestBit(_days), hour, minute);
+            break;
+        case Alarm2::WHEN_MINUTES_AND_HOURS_AND_DAY_OF_WEEK_MATCH:
+            alarm.writeAlarm(true, lowestBit(_daysOfWeek) + 1, hour, minute);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Checks whether the schedule is due.
+ *
+ * Call this method when the INT/SQW line is asserted (or periodically). It checks (and clears) the flag of the alarm
+ * and, only if the alarm was triggered and a residual predicate is needed, reads the date/time to evaluate it.
+ *
+ * @param alarm The second alarm, programmed by writeAlarm().
+ * @param clock The clock used to read the date/time.
+ * @return      True if the alarm was triggered at a time that matches the expression.
+ */
+bool CronSchedule::isDue(const Alarm2& alarm, RealTimeClock& clock) const
+{
+    if (!alarm.wasItTriggered())
+    {
+        return false;
+    }
+    if (!_residual)
+    {
+        return true;
+    }
+
+    return clock.readDateTime() && matches(clock);
+}
+
+/**
+ * Checks whether the date/time of a clock matches the expression.
+ *
+ * @param clock The clock, after reading the date/time.
+ * @return      True if it matches.
+ */
+bool CronSchedule::matches(const RealTimeClock& clock) const
+{
+    return matches(clock.getMonth(), clock.getDay(), clock.getDayOfWeek() - 1, clock.getHour(), clock.getMinute());
+}
+
+/**
+ * Checks whether a date/time matches the expression.
+ *
+ * @param month     The month (from 1 to 12).
+ * @param day       The day of the month (from 1 to 31).
+ * @param dayOfWeek The day of the week (from 0 to 6, where 0 is Sunday).
+ * @param hour      The hours (from 0 to 23).
+ * @param minute    The minutes (from 0 to 59).
+ * @return          True if it matches.
+ */
+bool CronSchedule::matches(uint8_t month, uint8_t day, uint8_t dayOfWeek, uint8_t hour, uint8_t minute) const
+{
+    if (!((_minutes >> minute) & 1) || !((_hours >> hour) & 1) || !((_months >> month) & 1))
+    {
+        return false;
+    }
+
+    bool dayMatches       = (_days >> day) & 1;
+    bool dayOfWeekMatches = (_daysOfWeek >> dayOfWeek) & 1;
+    if (_daysRestricted && _daysOfWeekRestricted)
+    {
+        return dayMatches || dayOfWeekMatches;
+    }
+    return dayMatches && dayOfWeekMatches;
+}
+
+/**
+ * Gets the alarm rate chosen by parse().
+ *
+ * @return The alarm rate.
+ */
+Alarm2::AlarmRate CronSchedule::getAlarmRate() const
+{
+    return _alarmRate;
+}
+
+/**
+ * Checks whether the alarm rate triggers at times that do not match the expression, which must be filtered.
+ *
+ * @return True if a residual predicate is evaluated on every wakeup.
+ */
+bool CronSchedule::hasResidual() const
+{
+    return _residual;
+}
+
+/**
+ * Parses a field of the expression and the spaces after it.
+ *
+ * @param cursor     The position in the expression, which is advanced.
+ * @param minimum    The smallest value of the field.
+ * @param maximum    The largest value of the field.
+ * @param bits       The values that match (bit N is value N).
+ * @param restricted Set to false if the field starts with "*".
+ * @return           True if the field is valid.
+ */
+bool CronSchedule::parseField(const char*& cursor, uint8_t minimum, uint8_t maximum, uint64_t& bits, bool& restricted)
+{
+    bits       = 0;
+    restricted = *cursor != '*';
+
+    for (;;)
+    {
+        uint8_t from = minimum;
+        uint8_t to   = maximum;
+        uint8_t step = 1;
+
+        if (*cursor == '*')
+        {
+            cursor++;
+        }
+        else
+        {
+            if (!parseNumber(cursor, from))
+            {
+                return false;
+            }
+            to = from;
+            if (*cursor == '-')
+            {
+                cursor++;
+                if (!parseNumber(cursor, to))
+                {
+                    return false;
+                }
+            }
+            else if (*cursor == '/')
+            {
+                to = maximum; //"N/step" means "N-maximum/step"
+            }
+        }
+
+        if (*cursor == '/')
+        {
+            cursor++;
+            if (!parseNumber(cursor, step) || step == 0)
+            {
+                return false;
+            }
+        }
+
+        if (from < minimum || to > maximum || from > to)
+        {
+            return false;
+        }
+        for (uint8_t value = from; value <= to && value >= from; value += step)
+        {
+            bits |= (uint64_t)1 << value;
+        }
+
+        if (*cursor != ',')
+        {
+            break;
+        }
+        cursor++;
+    }
+
+    if (*cursor != ' ' && *cursor != '\0')
+    {
+        return false;
+    }
+    while (*cursor == ' ')
+    {
+        cursor++;
+    }
+    return true;
+}
+
+/**
+ * Parses a decimal number of up to three digits.
+ *
+ * @param cursor The position in the expression, which is advanced.
+ * @param value  The number.
+ * @return       True if there was a number.
+ */
+bool CronSchedule::parseNumber(const char*& cursor, uint8_t& value)
+{
+    uint16_t number = 0;
+    uint8_t digits  = 0;
+    while (*cursor >= '0' && *cursor <= '9' && digits < 3)
+    {
+        number = number * 10 + (*cursor - '0');
+        cursor++;
+        digits++;
+    }
+    value = number > 255 ? 255 : number;
+    return digits > 0;
+}
+
+/**
+ * Counts the bits set.
+ *
+ * @param bits The bit set.
+ * @return     The number of bits set.
+ */
+uint8_t CronSchedule::countBits(uint64_t bits)
+{
+    uint8_t count = 0;
+    while (bits != 0)
+    {
+        bits &= bits - 1;
+        count++;
+    }
+    return count;
+}
+
+/**
+ * Finds the lowest bit set.
+ *
+ * @param bits The bit set (not zero).
+ * @return     The position of the lowest bit set.
+ */
+uint8_t CronSchedule::lowestBit(uint64_t bits)
+{
+    uint8_t position = 0;
+    while (!(bits & 1))
+    {
+        bits >>= 1;
+        position++;
+    }
+    return position;
+}
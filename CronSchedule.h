@@ -0,0 +1,114 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_CRON_SCHEDULE_H__
+#define __AMPLIAR_DS3231_CRON_SCHEDULE_H__
+
+#include <stdint.h>
+#include "Alarm2.h"
+#include "RealTimeClock.h"
+
+namespace Ampliar { namespace DS3231 {
+
+/**
+ * Recurring schedule described by a cron expression, compiled onto the second alarm of DS3231.
+ *
+ * The expression has the five fields of cron, separated by spaces: minute (0-59), hour (0-23), day of the month
+ * (1-31), month (1-12) and day of the week (0-7, where both 0 and 7 are Sunday). Each field is a comma-separated list
+ * of "*", "N" or "N-M", optionally followed by "/step". The shortcuts \@yearly, \@annually, \@monthly, \@weekly,
+ * \@daily, \@midnight and \@hourly are also accepted. As in cron, if both day fields are restricted, a day matches
+ * when either of them matches.
+ *
+ * parse() converts the expression into bit sets (16 bytes) and chooses the alarm rate with the fewest wakeups that
+ * still includes every match:
+ *
+ * - one minute, one hour and one day of the month (or of the week): WHEN_MINUTES_AND_HOURS_AND_DAY_MATCH (or
+ *   WHEN_MINUTES_AND_HOURS_AND_DAY_OF_WEEK_MATCH);
+ * - one minute and one hour: WHEN_MINUTES_AND_HOURS_MATCH;
+ * - one minute: WHEN_MINUTES_MATCH;
+ * - otherwise: ONCE_PER_MINUTE.
+ *
+ * Wakeups the alarm rate cannot exclude (e.g., other months) are filtered by a residual predicate on the date/time.
+ * When the alarm rate is exact, there is no residual predicate and isDue() does not even read the date/time.
+ *
+ * @author Daniel Murari Boatto
+ */
+class CronSchedule
+{
+public:
+    CronSchedule();
+    bool parse(const char* expression);
+    void writeAlarm(Alarm2& alarm) const;
+    bool isDue(const Alarm2& alarm, RealTimeClock& clock) const;
+    bool matches(const RealTimeClock& clock) const;
+    bool matches(uint8_t month, uint8_t day, uint8_t dayOfWeek, uint8_t hour, uint8_t minute) const;
+    Alarm2::AlarmRate getAlarmRate() const;
+    bool hasResidual() const;
+
+private:
+    static bool parseField(const char*& cursor, uint8_t minimum, uint8_t maximum, uint64_t& bits, bool& restricted);
+    static bool parseNumber(const char*& cursor, uint8_t& value);
+    static uint8_t countBits(uint64_t bits);
+    static uint8_t lowestBit(uint64_t bits);
+    void compile();
+
+    /**
+     * Minutes that match (bit N is minute N).
+     */
+    uint64_t _minutes;
+
+    /**
+     * Hours that match (bit N is hour N).
+     */
+    uint32_t _hours;
+
+    /**
+     * Days of the month that match (bit N is day N).
+     */
+    uint32_t _days;
+
+    /**
+     * Months that match (bit N is month N).
+     */
+    uint16_t _months;
+
+    /**
+     * Days of the week that match (bit N is day N, where 0 is Sunday).
+     */
+    uint8_t _daysOfWeek;
+
+    /**
+     * True if the day of the month field is not "*".
+     */
+    bool _daysRestricted;
+
+    /**
+     * True if the day of the week field is not "*".
+     */
+    bool _daysOfWeekRestricted;
+
+    /**
+     * Alarm rate chosen by parse().
+     */
+    Alarm2::AlarmRate _alarmRate;
+
+    /**
+     * True if some wakeups of the alarm rate do not match the expression.
+     */
+    bool _residual;
+};
+
+}} //end of namespace
+#endif //__AMPLIAR_DS3231_CRON_SCHEDULE_H__
@@ -0,0 +1,353 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_DATE_TIME_H__
+#define __AMPLIAR_DS3231_DATE_TIME_H__
+
+#include <stdint.h>
+#include "Calendar.h"
+
+namespace Ampliar { namespace DS3231 {
+
+#define RTC_DATETIME_MIN_YEAR 2000 ///< First year a DateTime can hold
+#define RTC_DATETIME_MAX_YEAR 2063 ///< Last year a DateTime can hold
+
+/**
+ * A date/time packed into a 32-bit word.
+ *
+ * The fields are stored from the most significant to the least significant bits: year - 2000 (6 bits), month
+ * (4 bits), day (5 bits), hour (5 bits), minute (6 bits) and second (6 bits). Therefore, the packed words sort in
+ * chronological order and the comparison operators compare them directly, and a DateTime takes 4 bytes, against
+ * the 8 bytes of the fields of RealTimeClock. The day of the week is not stored, but calculated by getDayOfWeek().
+ *
+ * The class is trivially copyable and all its methods are constexpr, so it can be stored in ring buffers, compared
+ * in interrupt handlers and built at compile-time:
+ *
+ * ~~~~~~~~~~~~~~~{.cpp}
+ * constexpr DateTime deadline(2030, 1, 1, 12, 0, 0);
+ * if (clock.readNow() >= deadline) { ... }
+ * ~~~~~~~~~~~~~~~
+ *
+ * \b Note: Only years from RTC_DATETIME_MIN_YEAR to RTC_DATETIME_MAX_YEAR can be represented. Dates out of this range
+ * (e.g., from the 20th century, which DS3231 can hold) give an invalid date/time.
+ *
+ * @author Daniel Murari Boatto
+ */
+class DateTime
+{
+public:
+    /**
+     * Creates an invalid date/time (see isValid()), whose packed word is zero.
+     */
+    constexpr DateTime():
+        _packed(0)
+    {
+    }
+
+    /**
+     * Creates a date/time from its fields.
+     *
+     * If any field is out of its range (including a day past the end of the month, or a year that cannot be
+     * represented), the date/time is invalid (see isValid()), instead of wrapping around into another date.
+     *
+     * @param year   The year with century (from RTC_DATETIME_MIN_YEAR to RTC_DATETIME_MAX_YEAR).
+     * @param month  The month (from 1 to 12).
+     * @param day    The day of the month (from 1 to 31).
+     * @param hour   The hours in 24-hour format (from 0 to 23).
+     * @param minute The minutes (from 0 to 59).
+     * @param second The seconds (from 0 to 59).
+     */
+    constexpr DateTime(int16_t year, uint8_t month, uint8_t day, uint8_t hour = 0, uint8_t minute = 0,
+                       uint8_t second = 0):
+        _packed(isInRange(year, month, day, hour, minute, second)
+                    ? (uint32_t)(year - RTC_DATETIME_MIN_YEAR) << 26 | (uint32_t)month << 22 | (uint32_t)day << 17
+                      | (uint32_t)hour << 12 | (uint16_t)minute << 6 | second
+                    : 0)
+    {
+    }
+
+    /**
+     * Creates a date/time from a packed word (see getPacked()).
+     *
+     * @param packed The packed word.
+     * @return       The date/time.
+     */
+    static constexpr DateTime fromPacked(uint32_t packed)
+    {
+        return DateTime(packed, 0);
+    }
+
+    /**
+     * Creates a date/time from a Unix time.
+     *
+     * @param time The number of seconds since 1970-01-01 00:00:00 (from 2000-01-01 to 2063-12-31).
+     * @return     The date/time, or an invalid one (see isValid()) if it is out of this range.
+     */
+    static constexpr DateTime fromUnixTime(uint32_t time)
+    {
+        return fromCivil(Calendar::civilFromDays(Calendar::daysFromUnixTime(time)), Calendar::secondsOfDay(time));
+    }
+
+    /**
+     * Gets the packed word, e.g., to store the date/time.
+     *
+     * @return The packed word.
+     */
+    constexpr uint32_t getPacked() const
+    {
+        return _packed;
+    }
+
+    /**
+     * Gets the year.
+     *
+     * @return The year with century (format yyyy).
+     */
+    constexpr int16_t getYear() const
+    {
+        return RTC_DATETIME_MIN_YEAR + (_packed >> 26);
+    }
+
+    /**
+     * Gets the month.
+     *
+     * @return The month (from 1 to 12).
+     */
+    constexpr uint8_t getMonth() const
+    {
+        return (_packed >> 22) & 0x0F;
+    }
+
+    /**
+     * Gets the day of the month.
+     *
+     * @return The day of the month (from 1 to 31).
+     */
+    constexpr uint8_t getDay() const
+    {
+        return (_packed >> 17) & 0x1F;
+    }
+
+    /**
+     * Gets the hours.
+     *
+     * @return The hours in 24-hour format (from 0 to 23).
+     */
+    constexpr uint8_t getHour() const
+    {
+        return (_packed >> 12) & 0x1F;
+    }
+
+    /**
+     * Gets the minutes.
+     *
+     * @return The minutes (from 0 to 59).
+     */
+    constexpr uint8_t getMinute() const
+    {
+        return (_packed >> 6) & 0x3F;
+    }
+
+    /**
+     * Gets the seconds.
+     *
+     * @return The seconds (from 0 to 59).
+     */
+    constexpr uint8_t getSecond() const
+    {
+        return _packed & 0x3F;
+    }
+
+    /**
+     * Calculates the day of the week, numbered like the day of the week register of DS3231.
+     *
+     * @return The day of the week (from 1 to 7, where 1 is Sunday).
+     */
+    constexpr uint8_t getDayOfWeek() const
+    {
+        return Calendar::weekday(getYear(), getMonth(), getDay()) + 1;
+    }
+
+    /**
+     * Gets the day of the year.
+     *
+     * @return The day of the year (from 1 to 366).
+     */
+    constexpr uint16_t getDayOfYear() const
+    {
+        return Calendar::dayOfYear(getYear(), getMonth(), getDay());
+    }
+
+    /**
+     * Gets the ISO 8601 week (see Calendar::isoWeek()).
+     *
+     * @return The week (from 1 to 53).
+     */
+    constexpr uint8_t getIsoWeek() const
+    {
+        return Calendar::isoWeek(getYear(), getMonth(), getDay());
+    }
+
+    /**
+     * Gets the number of days of the month.
+     *
+     * @return The number of days (from 28 to 31).
+     */
+    constexpr uint8_t getDaysInMonth() const
+    {
+        return Calendar::daysInMonth(getYear(), getMonth());
+    }
+
+    /**
+     * Checks whether the year is a leap year.
+     *
+     * @return True if February has 29 days in this year.
+     */
+    constexpr bool isLeapYear() const
+    {
+        return Calendar::isLeapYear(getYear());
+    }
+
+    /**
+     * Converts the date/time to Unix time.
+     *
+     * @return The number of seconds since 1970-01-01 00:00:00.
+     */
+    constexpr uint32_t getUnixTime() const
+    {
+        return Calendar::toUnixTime(getYear(), getMonth(), getDay(), getHour(), getMinute(), getSecond());
+    }
+
+    /**
+     * Adds a number of seconds.
+     *
+     * @param seconds The number of seconds to add (negative to subtract).
+     * @return        The resulting date/time.
+     */
+    constexpr DateTime addSeconds(int32_t seconds) const
+    {
+        return fromUnixTime(Calendar::addSeconds(getUnixTime(), seconds));
+    }
+
+    /**
+     * Adds a number of days. The time of the day is kept.
+     *
+     * @param days The number of days to add (negative to subtract).
+     * @return     The resulting date/time.
+     */
+    constexpr DateTime addDays(int32_t days) const
+    {
+        return fromUnixTime(Calendar::addDays(getUnixTime(), days));
+    }
+
+    /**
+     * Adds a number of months, limiting the day to the length of the resulting month (see Calendar::addMonths()).
+     *
+     * @param months The number of months to add (negative to subtract).
+     * @return       The resulting date/time.
+     */
+    constexpr DateTime addMonths(int32_t months) const
+    {
+        return fromUnixTime(Calendar::addMonths(getUnixTime(), months));
+    }
+
+    /**
+     * Calculates the number of seconds until another date/time.
+     *
+     * @param other The other date/time.
+     * @return      The number of seconds (negative if the other date/time is earlier).
+     */
+    constexpr int32_t secondsUntil(const DateTime& other) const
+    {
+        return Calendar::secondsBetween(getUnixTime(), other.getUnixTime());
+    }
+
+    /**
+     * Calculates the number of days until the date of another date/time.
+     *
+     * @param other The other date/time.
+     * @return      The number of days (negative if the other date is earlier).
+     */
+    constexpr int32_t daysUntil(const DateTime& other) const
+    {
+        return Calendar::daysBetween(getUnixTime(), other.getUnixTime());
+    }
+
+    /**
+     * Checks whether the fields are within their ranges, including the day against the length of the month. A
+     * date/time created by the default constructor, from fields out of range or out of the years it can hold, or
+     * returned by a failed read, is invalid.
+     *
+     * @return True if the date/time is valid.
+     */
+    constexpr bool isValid() const
+    {
+        return isInRange(getYear(), getMonth(), getDay(), getHour(), getMinute(), getSecond());
+    }
+
+    constexpr bool operator==(const DateTime& other) const { return _packed == other._packed; }
+    constexpr bool operator!=(const DateTime& other) const { return _packed != other._packed; }
+    constexpr bool operator<(const DateTime& other) const  { return _packed < other._packed; }
+    constexpr bool operator<=(const DateTime& other) const { return _packed <= other._packed; }
+    constexpr bool operator>(const DateTime& other) const  { return _packed > other._packed; }
+    constexpr bool operator>=(const DateTime& other) const { return _packed >= other._packed; }
+
+private:
+    /**
+     * Creates a date/time from a packed word (the second argument only distinguishes this constructor).
+     */
+    constexpr DateTime(uint32_t packed, int):
+        _packed(packed)
+    {
+    }
+
+    /**
+     * Checks whether the fields of a date/time are within their ranges and the year can be represented.
+     */
+    static constexpr bool isInRange(int16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute,
+                                    uint8_t second)
+    {
+        return year >= RTC_DATETIME_MIN_YEAR && year <= RTC_DATETIME_MAX_YEAR && month >= 1 && month <= 12 && day >= 1
+               && day <= Calendar::daysInMonth(year, month) && hour < 24 && minute < 60 && second < 60;
+    }
+
+    /**
+     * Creates a date/time from a civil date and the number of seconds since midnight (invalid if the year cannot be
+     * represented).
+     */
+    static constexpr DateTime fromCivil(Calendar::CivilDate date, uint32_t secondsOfDay)
+    {
+        return DateTime(date.year, date.month, date.day, secondsOfDay / 3600, secondsOfDay / 60 % 60,
+                        secondsOfDay % 60);
+    }
+
+    /**
+     * The fields, packed in chronological order.
+     */
+    uint32_t _packed;
+};
+
+static_assert(sizeof(DateTime) == 4, "DateTime must be packed into 32 bits");
+static_assert(DateTime(2063, 12, 31, 23, 59, 59) > DateTime(2000, 1, 1), "Packed words must sort chronologically");
+static_assert(DateTime::fromUnixTime(946684800UL) == DateTime(2000, 1, 1), "2000-01-01 00:00:00 is 946684800");
+static_assert(!DateTime::fromUnixTime(946684799UL).isValid(), "Years before RTC_DATETIME_MIN_YEAR must not wrap");
+static_assert(!DateTime(2064, 1, 1).isValid() && !DateTime(1900, 1, 1).isValid(), "Years out of range are invalid");
+static_assert(!DateTime(2023, 2, 29).isValid() && DateTime(2024, 2, 29).isValid(), "Days are checked against months");
+static_assert(DateTime(2015, 12, 27).getDayOfWeek() == 1, "2015-12-27 was a Sunday");
+static_assert(DateTime(2024, 1, 31, 8).addMonths(1) == DateTime(2024, 2, 29, 8), "Months are added with clamping");
+static_assert(DateTime(2024, 12, 31, 23, 59, 59).addSeconds(1) == DateTime(2025, 1, 1), "Seconds carry into years");
+
+}} //end of namespace
+#endif //__AMPLIAR_DS3231_DATE_TIME_H__
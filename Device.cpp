@@ -0,0 +1,496 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Device.h"
+#include "RegisterSnapshot.h"
+
+using namespace Ampliar::DS3231;
+
+/**
+ * Creates a device behind a channel of a multiplexer.
+ *
+ * @param mux     The multiplexer. It must remain valid while this object exists.
+ * @param channel The channel of the multiplexer (from 0 to 7).
+ * @param address The I2C address of the device.
+ */
+Device::Device(I2cMux& mux, uint8_t channel, uint8_t address):
+    _transport(&mux.getTransport()), _mux(&mux), _address(address), _channel(channel), _shadowEnabled(false),
+    _shadowValid(0), _shadowRegisters(), _asyncAddress(0), _asyncRegisters(), _asyncHandler(0), _asyncOwner(0)
+{
+    //
+}
+
+/**
+ * Sets the bus of the device.
+ *
+ * The transport is started and the shadow cache is invalidated. If the device is behind a multiplexer, it is no
+ * longer.
+ *
+ * @param transport The bus. It must remain valid while it is in use.
+ */
+void Device::setTransport(BusTransport& transport)
+{
+    _transport = &transport;
+    _mux       = 0;
+    _transport->begin();
+    invalidate();
+}
+
+/**
+ * Gets the bus of the device.
+ *
+ * @return The bus transport, or null if none was set.
+ */
+BusTransport* Device::getTransport() const
+{
+    return _transport;
+}
+
+/**
+ * Gets the multiplexer in front of the device.
+ *
+ * @return The multiplexer, or null if the device is attached directly to the bus.
+ */
+I2cMux* Device::getMux() const
+{
+    return _mux;
+}
+
+/**
+ * Gets the channel of the multiplexer in front of the device.
+ *
+ * @return The channel (meaningless if there is no multiplexer).
+ */
+uint8_t Device::getChannel() const
+{
+    return _channel;
+}
+
+/**
+ * Gets the I2C address of the device.
+ *
+ * @return The I2C address.
+ */
+uint8_t Device::getAddress() const
+{
+    return _address;
+}
+
+/**
+ * Enables the shadow cache of this device.
+ *
+ * @see BaseClock::enableShadowCache().
+ */
+void Device::enableShadowCache()
+{
+    _shadowEnabled = true;
+}
+
+/**
+ * Disables the shadow cache of this device.
+ *
+ * @see BaseClock::disableShadowCache().
+ */
+void Device::disableShadowCache()
+{
+    _shadowEnabled = false;
+    _shadowValid   = 0;
+}
+
+/**
+ * Checks whether the shadow cache of this device is enabled or not.
+ *
+ * @return True if it is enabled.
+ */
+bool Device::isShadowCacheEnabled() const
+{
+    return _shadowEnabled;
+}
+
+/**
+ * Discards the copy of the registers kept by the shadow cache of this device.
+ *
+ * @see BaseClock::invalidate().
+ */
+void Device::invalidate()
+{
+    _shadowValid = 0;
+}
+
+/**
+ * Reloads the shadow cache of this device.
+ *
+ * @see BaseClock::refresh().
+ */
+void Device::refresh()
+{
+    if (!_shadowEnabled)
+    {
+        return;
+    }
+
+    uint8_t registers[RTC_SHADOW_SIZE];
+    if (!readRegisters(RTC_SHADOW_FIRST, registers, RTC_SHADOW_SIZE))
+    {
+        invalidate();
+    }
+}
+
+/**
+ * Reads the whole register file of this device in a single I2C transaction.
+ *
+ * @see BaseClock::readSnapshot().
+ *
+ * @param snapshot The object that will receive the content of the registers.
+ * @return         True if successful or false, otherwise.
+ */
+bool Device::readSnapshot(RegisterSnapshot& snapshot)
+{
+    return readRegisters(RTC_ADDR_DATE, snapshot._registers, RTC_SNAPSHOT_SIZE);
+}
+
+/**
+ * Reads the status register of this device once and acknowledges the alarms that were triggered.
+ *
+ * @see BaseClock::pollEvents().
+ *
+ * @return A combination of RTC_EVENT_ALARM1, RTC_EVENT_ALARM2, RTC_EVENT_BUSY and RTC_EVENT_OSCILLATOR_STOPPED.
+ */
+uint8_t Device::pollEvents()
+{
+    //like RealTimeClock::wasItStopped(), a status register that cannot be read does not vouch for the date/time
+    uint8_t statusRegister;
+    if (!readRegister(RTC_ADDR_STATUS, statusRegister))
+    {
+        return RTC_EVENT_OSCILLATOR_STOPPED;
+    }
+    uint8_t events         = statusRegister & RTC_REG_STATUS_VOLATILE_MASK;
+
+    uint8_t alarms = events & (RTC_EVENT_ALARM1 | RTC_EVENT_ALARM2);
+    if (alarms)
+    {
+        statusRegister = (statusRegister & ~RTC_REG_STATUS_VOLATILE_MASK) | RTC_REG_STATUS_STICKY_MASK;
+        writeRegister(RTC_ADDR_STATUS, statusRegister & ~alarms);
+    }
+    return events;
+}
+
+/**
+ * Reads one byte from a register at a given address.
+ *
+ * Check the datasheet or the header BaseClock.h to get the registers available and their addresses.
+ *
+ * @param address The address of the register.
+ * @return        The content of the register (zero if the read failed).
+ */
+uint8_t Device::readRegister(uint8_t address)
+{
+    uint8_t value = 0;
+    readRegisters(address, &value, 1);
+    return value;
+}
+
+/**
+ * Reads one byte from a register at a given address, reporting whether the read succeeded.
+ *
+ * Use this method when a failed read must not be mistaken for a register holding zero, e.g., before a
+ * read-modify-write or when checking a flag.
+ *
+ * @param address The address of the register.
+ * @param value   The variable that receives the content of the register (unchanged if the read failed).
+ * @return        True if successful or false, otherwise.
+ */
+bool Device::readRegister(uint8_t address, uint8_t& value)
+{
+    uint8_t read;
+    if (!readRegisters(address, &read, 1))
+    {
+        return false;
+    }
+    value = read;
+    return true;
+}
+
+/**
+ * Reads the configuration bits of a register, using the shadow cache when possible.
+ *
+ * If the shadow cache is enabled and holds a valid copy of the register, this method returns the copy without any
+ * I2C communication. Otherwise, it reads the register from the device (refreshing the copy).
+ *
+ * The volatile bits of the returned value must not be trusted when the copy is used. For the status register, the
+ * bits A1F, A2F and OSF are returned as 1 (one), since writing 1 (one) on them leaves their value unchanged. Thus, the
+ * value can be modified and written back with writeRegister() without clearing any flag by accident. For the control
+ * register, the bit CONV is returned as 0 (zero).
+ *
+ * Use readRegister() to read volatile bits, like A1F, A2F, BSY, OSF and CONV.
+ *
+ * @param address The address of the register.
+ * @return        The content of the register (zero if the read failed).
+ */
+uint8_t Device::readCachedRegister(uint8_t address)
+{
+    uint8_t value = 0;
+    readCachedRegisters(address, &value, 1);
+    return value;
+}
+
+/**
+ * Reads the configuration bits of a register, using the shadow cache when possible, reporting whether the read
+ * succeeded (see readCachedRegister()).
+ *
+ * Read-modify-write operations use this method, so they never write back a register rebuilt from a failed read.
+ *
+ * @param address The address of the register.
+ * @param value   The variable that receives the content of the register (unchanged if the read failed).
+ * @return        True if successful or false, otherwise.
+ */
+bool Device::readCachedRegister(uint8_t address, uint8_t& value)
+{
+    uint8_t read;
+    if (!readCachedRegisters(address, &read, 1))
+    {
+        return false;
+    }
+    value = read;
+    return true;
+}
+
+/**
+ * Reads the configuration bits of consecutive registers, using the shadow cache when possible.
+ *
+ * If the shadow cache holds a valid copy of all the registers, no I2C communication happens. Otherwise, all of them
+ * are read in a single I2C transaction. The volatile bits follow the same rules of readCachedRegister().
+ *
+ * @param address The address of the first register.
+ * @param buffer  The buffer that will receive the content of the registers.
+ * @param length  The number of registers.
+ * @return        True if successful or false, otherwise.
+ */
+bool Device::readCachedRegisters(uint8_t address, uint8_t* buffer, uint8_t length)
+{
+    bool cached = _shadowEnabled && address >= RTC_SHADOW_FIRST && address + length - 1 <= RTC_SHADOW_LAST;
+    for (uint8_t i = 0; cached && i < length; i++)
+    {
+        uint8_t index = address + i - RTC_SHADOW_FIRST;
+        cached = (_shadowValid >> index) & 1;
+        buffer[i] = _shadowRegisters[index];
+    }
+
+    if (!cached && !readRegisters(address, buffer, length))
+    {
+        return false;
+    }
+
+    //Same rules with a cold or a warm cache
+    for (uint8_t i = 0; i < length; i++)
+    {
+        if (address + i == RTC_ADDR_STATUS)
+        {
+            buffer[i] = (buffer[i] & ~RTC_REG_STATUS_VOLATILE_MASK) | RTC_REG_STATUS_STICKY_MASK;
+        }
+        else if (address + i == RTC_ADDR_CONTROL)
+        {
+            buffer[i] &= ~RTC_REG_CONTROL_VOLATILE_MASK;
+        }
+    }
+    return true;
+}
+
+/**
+ * Write one byte in a register at a given address.
+ *
+ * Check the datasheet or the header BaseClock.h to get the registers available and their addresses.
+ *
+ * @param address The address of the register.
+ * @param value   The value to be written in the register.
+ * @return        True if successful or false, otherwise.
+ */
+bool Device::writeRegister(uint8_t address, uint8_t value)
+{
+    return writeRegisters(address, &value, 1);
+}
+
+/**
+ * Reads consecutive registers in a single I2C transaction.
+ *
+ * The device increments its register pointer after each byte, so a block of registers (like the date/time or an
+ * alarm) can be read at once. If the device is behind a multiplexer, its channel is selected first (see I2cMux).
+ *
+ * The shadowed registers among them are updated in the shadow cache.
+ *
+ * @param address The address of the first register.
+ * @param buffer  The buffer that will receive the content of the registers.
+ * @param length  The number of registers.
+ * @return        True if successful or false, otherwise.
+ */
+bool Device::readRegisters(uint8_t address, uint8_t* buffer, uint8_t length)
+{
+    if (!select() || !_transport->writeRead(_address, &address, 1, buffer, length))
+    {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < length; i++)
+    {
+        updateShadow(address + i, buffer[i]);
+    }
+    return true;
+}
+
+/**
+ * Writes consecutive registers in a single I2C transaction.
+ *
+ * The shadowed registers among them are updated in the shadow cache (write-through).
+ *
+ * @param address The address of the first register.
+ * @param buffer  The values to be written.
+ * @param length  The number of registers (up to RTC_SNAPSHOT_SIZE).
+ * @return        True if successful or false, otherwise.
+ */
+bool Device::writeRegisters(uint8_t address, const uint8_t* buffer, uint8_t length)
+{
+    uint8_t data[RTC_SNAPSHOT_SIZE + 1];
+    data[0] = address;
+    for (uint8_t i = 0; i < length; i++)
+    {
+        data[i + 1] = buffer[i];
+    }
+    if (!select() || !_transport->write(_address, data, length + 1))
+    {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < length; i++)
+    {
+        updateShadow(address + i, buffer[i]);
+    }
+    return true;
+}
+
+/**
+ * Starts an asynchronous read of consecutive registers (see BusTransport::beginWriteRead()).
+ *
+ * Only one asynchronous read may be pending on this device. Devices attached to the same bus also share its transfer,
+ * so a read is not started while the bus holds the transfer of another device.
+ *
+ * The multiplexer channel, if any, is selected synchronously before the read starts. The shadow cache is not updated.
+ *
+ * @see BaseClock::beginAsyncRead().
+ *
+ * @param address The address of the first register.
+ * @param length  The number of registers (up to RTC_SNAPSHOT_SIZE).
+ * @param handler The function called by poll() when the read finishes.
+ * @param owner   The object passed to the handler.
+ * @return        True if the read was started, or false if another read is still pending.
+ */
+bool Device::beginAsyncRead(uint8_t address, uint8_t length, BaseClock::AsyncHandler handler, BaseClock* owner)
+{
+    if (_asyncHandler)
+    {
+        return false;
+    }
+
+    _asyncAddress = address;
+    if (!select() || !_transport->beginWriteRead(_address, &_asyncAddress, 1, _asyncRegisters, length))
+    {
+        return false;
+    }
+
+    _asyncHandler = handler;
+    _asyncOwner   = owner;
+    return true;
+}
+
+/**
+ * Advances the pending asynchronous read of this device.
+ *
+ * Call this method periodically (e.g., on every iteration of loop()) after starting an asynchronous read on this
+ * device. When the read finishes, this method calls its completion callback. It never blocks.
+ *
+ * @see BaseClock::poll().
+ *
+ * @return True if a read is still pending.
+ */
+bool Device::poll()
+{
+    if (!_asyncHandler)
+    {
+        return false;
+    }
+
+    BusTransport::TransferState state = _transport->poll();
+    if (state == BusTransport::TRANSFER_PENDING)
+    {
+        return true;
+    }
+
+    //Releases the slot before calling the handler, so the callback can start another read
+    BaseClock::AsyncHandler handler = _asyncHandler;
+    BaseClock* owner                = _asyncOwner;
+    _asyncHandler = 0;
+    _asyncOwner   = 0;
+
+    handler(owner, _asyncRegisters, state == BusTransport::TRANSFER_DONE);
+    return _asyncHandler != 0;
+}
+
+/**
+ * Checks whether an asynchronous read of this device is pending.
+ *
+ * @return True if a read is pending.
+ */
+bool Device::isReadPending() const
+{
+    return _asyncHandler != 0;
+}
+
+/**
+ * Selects the multiplexer channel of the device, if there is a multiplexer.
+ *
+ * @return True if successful or false, otherwise.
+ */
+bool Device::select()
+{
+    return !_mux || _mux->select(_channel);
+}
+
+/**
+ * Updates the copy of a register in the shadow cache.
+ *
+ * It does nothing if the shadow cache is disabled or if the register is not shadowed. Volatile bits are discarded.
+ *
+ * @param address The address of the register.
+ * @param value   The content of the register.
+ */
+void Device::updateShadow(uint8_t address, uint8_t value)
+{
+    if (!_shadowEnabled || address < RTC_SHADOW_FIRST || address > RTC_SHADOW_LAST)
+    {
+        return;
+    }
+
+    if (address == RTC_ADDR_STATUS)
+    {
+        value &= ~RTC_REG_STATUS_VOLATILE_MASK;
+    }
+    else if (address == RTC_ADDR_CONTROL)
+    {
+        value &= ~RTC_REG_CONTROL_VOLATILE_MASK;
+    }
+
+    uint8_t index = address - RTC_SHADOW_FIRST;
+    _shadowRegisters[index] = value;
+    _shadowValid |= (1 << index);
+}
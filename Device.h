@@ -0,0 +1,163 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_DEVICE_H__
+#define __AMPLIAR_DS3231_DEVICE_H__
+
+#include <stdint.h>
+#include "BaseClock.h"
+#include "BusTransport.h"
+#include "I2cMux.h"
+
+namespace Ampliar { namespace DS3231 {
+
+/**
+ * One DS3231: the bus it is attached to, the multiplexer channel in front of it (if any) and its I2C address.
+ *
+ * Every object of this library (RealTimeClock, RealTimeClockController, the alarms, etc.) talks to a device. By
+ * default, it is the default device of BaseClock, attached to the transport set with BaseClock::setTransport(). To
+ * talk to other devices, create a Device for each one and pass it to the constructors:
+ *
+ * ~~~~~~~~~~~~~~~{.cpp}
+ * LinuxI2cTransport bus("/dev/i2c-1");
+ * I2cMux mux(bus);
+ * Device device(mux, 3);          //channel 3 of the multiplexer
+ * RealTimeClock clock(device);
+ * ~~~~~~~~~~~~~~~
+ *
+ * Each device keeps its own shadow cache (see BaseClock::enableShadowCache()) and its own pending asynchronous read
+ * (see poll()), so devices on different buses share no state and can be accessed from different threads (one thread
+ * per bus, see FleetReader).
+ *
+ * @author Daniel Murari Boatto
+ */
+class Device
+{
+public:
+    /**
+     * Creates a device without a bus, at the default address. Set the bus with setTransport().
+     */
+    constexpr Device():
+        _transport(0), _mux(0), _address(RTC_ADDR_I2C), _channel(0), _shadowEnabled(false), _shadowValid(0),
+        _shadowRegisters(), _asyncAddress(0), _asyncRegisters(),
+        _asyncHandler(0), _asyncOwner(0)
+    {
+        //
+    }
+
+    /**
+     * Creates a device attached directly to a bus.
+     *
+     * @param transport The bus. It must remain valid while this object exists.
+     * @param address   The I2C address of the device.
+     */
+    constexpr explicit Device(BusTransport& transport, uint8_t address = RTC_ADDR_I2C):
+        _transport(&transport), _mux(0), _address(address), _channel(0), _shadowEnabled(false), _shadowValid(0),
+        _shadowRegisters(), _asyncAddress(0), _asyncRegisters(),
+        _asyncHandler(0), _asyncOwner(0)
+    {
+        //
+    }
+
+    Device(I2cMux& mux, uint8_t channel, uint8_t address = RTC_ADDR_I2C);
+    void setTransport(BusTransport& transport);
+    BusTransport* getTransport() const;
+    I2cMux* getMux() const;
+    uint8_t getChannel() const;
+    uint8_t getAddress() const;
+    //
+    void enableShadowCache();
+    void disableShadowCache();
+    bool isShadowCacheEnabled() const;
+    void invalidate();
+    void refresh();
+    bool readSnapshot(RegisterSnapshot& snapshot);
+    uint8_t pollEvents();
+    //
+    uint8_t readRegister(uint8_t address);
+    bool readRegister(uint8_t address, uint8_t& value);
+    uint8_t readCachedRegister(uint8_t address);
+    bool readCachedRegister(uint8_t address, uint8_t& value);
+    bool readCachedRegisters(uint8_t address, uint8_t* buffer, uint8_t length);
+    bool writeRegister(uint8_t address, uint8_t value);
+    bool readRegisters(uint8_t address, uint8_t* buffer, uint8_t length);
+    bool writeRegisters(uint8_t address, const uint8_t* buffer, uint8_t length);
+    //
+    bool beginAsyncRead(uint8_t address, uint8_t length, BaseClock::AsyncHandler handler, BaseClock* owner);
+    bool poll();
+    bool isReadPending() const;
+
+private:
+    bool select();
+    void updateShadow(uint8_t address, uint8_t value);
+
+    /**
+     * Bus of the device (the bus of the multiplexer, if any).
+     */
+    BusTransport* _transport;
+
+    /**
+     * Multiplexer in front of the device (null if none).
+     */
+    I2cMux* _mux;
+
+    /**
+     * I2C address of the device.
+     */
+    uint8_t _address;
+
+    /**
+     * Channel of the multiplexer.
+     */
+    uint8_t _channel;
+
+    /**
+     * Indicates whether the shadow cache is enabled or not.
+     */
+    bool _shadowEnabled;
+
+    /**
+     * Bit mask of the shadowed registers holding a valid copy (bit 0 is RTC_SHADOW_FIRST).
+     */
+    uint16_t _shadowValid;
+
+    /**
+     * Copy of the alarm, control, status and aging registers, without their volatile bits.
+     */
+    uint8_t _shadowRegisters[RTC_SHADOW_SIZE];
+
+    /**
+     * Register address of the pending asynchronous read (used as the transmit buffer).
+     */
+    uint8_t _asyncAddress;
+
+    /**
+     * Buffer of the pending asynchronous read.
+     */
+    uint8_t _asyncRegisters[RTC_SNAPSHOT_SIZE];
+
+    /**
+     * Function called when the pending asynchronous read finishes (null if there is no pending read).
+     */
+    BaseClock::AsyncHandler _asyncHandler;
+
+    /**
+     * Object that started the pending asynchronous read.
+     */
+    BaseClock* _asyncOwner;
+};
+
+}} //end of namespace
+#endif //__AMPLIAR_DS3231_DEVICE_H__
@@ -0,0 +1,314 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <math.h>
+#include "DriftEstimator.h"
+
+using namespace Ampliar::DS3231;
+
+/**
+ * Creates an estimator without observations.
+ */
+DriftEstimator::DriftEstimator()
+{
+    reset();
+}
+
+/**
+ * Discards all observations and starts a new fit.
+ */
+void DriftEstimator::reset()
+{
+    _offsetFit.reset();
+    _temperatureFit.reset();
+    _firstTime       = 0;
+    _lastTime        = 0;
+    _lastOffset      = 0;
+    _lastTemperature = 0;
+    _count           = 0;
+    _temperatureSum  = 0;
+}
+
+/**
+ * Adds an observation of the device time against the reference time.
+ *
+ * Both times must be taken at the same moment. Since they have a resolution of one second, the observations should
+ * span several days: the uncertainty of the drift is roughly the resolution divided by the span.
+ *
+ * @param rtcTime        The time of the device (Unix time, see RealTimeClock::readUnixTime()).
+ * @param referenceTime  The time of the reference clock (Unix time).
+ * @param quarterDegrees The temperature, in quarters of a degree Celsius.
+ * @return               True if the observation was added, or false if the reference time is not later than the
+ *                       one of the previous observation.
+ */
+bool DriftEstimator::addObservation(uint32_t rtcTime, uint32_t referenceTime, int16_t quarterDegrees)
+{
+    return addOffset(referenceTime, (int32_t)(rtcTime - referenceTime) * 1000, quarterDegrees);
+}
+
+/**
+ * Adds an observation of the offset between the device and the reference clock.
+ *
+ * This method works like addObservation(), but it takes the offset with millisecond resolution (e.g., measured with
+ * SubSecondClock), which shortens the span needed for a given uncertainty.
+ *
+ * @param referenceTime  The time of the reference clock (Unix time).
+ * @param offsetMillis   The time of the device minus the time of the reference, in milliseconds (up to ~24 days).
+ * @param quarterDegrees The temperature, in quarters of a degree Celsius.
+ * @return               True if the observation was added, or false if the reference time is not later than the
+ *                       one of the previous observation.
+ */
+bool DriftEstimator::addOffset(uint32_t referenceTime, int32_t offsetMillis, int16_t quarterDegrees)
+{
+    if (_count == 0xFFFF || (_count > 0 && (int32_t)(referenceTime - _lastTime) <= 0))
+    {
+        return false;
+    }
+
+    if (_count == 0)
+    {
+        _firstTime = referenceTime;
+    }
+    else
+    {
+        //Drift of the interval since the last observation, against the mean temperature of the interval
+        uint32_t interval  = referenceTime - _lastTime;
+        double drift       = (double)(offsetMillis - _lastOffset) * 1000 / interval;
+        double temperature = (quarterDegrees + _lastTemperature) / 8.0;
+        _temperatureFit.add(temperature, drift, interval);
+    }
+
+    _offsetFit.add(referenceTime - _firstTime, offsetMillis, 1);
+    _lastTime        = referenceTime;
+    _lastOffset      = offsetMillis;
+    _lastTemperature = quarterDegrees;
+    _temperatureSum += quarterDegrees;
+    _count++;
+    return true;
+}
+
+/**
+ * Reads the time and the temperature of the device and adds them as an observation.
+ *
+ * @param clock         The clock used to read the device.
+ * @param referenceTime The time of the reference clock (Unix time), taken right before calling this method.
+ * @return              True if the observation was added, or false if the device could not be read or the observation
+ *                      was rejected (see addObservation()).
+ */
+bool DriftEstimator::observe(RealTimeClock& clock, uint32_t referenceTime)
+{
+    uint32_t rtcTime = clock.readUnixTime();
+    if (rtcTime == 0)
+    {
+        return false;
+    }
+
+    int16_t quarterDegrees = clock.readTemperatureQuarterDegrees();
+    if (quarterDegrees == RTC_TEMPERATURE_INVALID)
+    {
+        return false;
+    }
+    return addObservation(rtcTime, referenceTime, quarterDegrees);
+}
+
+/**
+ * Gets the number of observations in the fit.
+ *
+ * @return The number of observations since the last reset.
+ */
+uint16_t DriftEstimator::getObservationCount() const
+{
+    return _count;
+}
+
+/**
+ * Gets the time covered by the observations in the fit.
+ *
+ * @return The number of seconds between the first and the last observation.
+ */
+uint32_t DriftEstimator::getSpan() const
+{
+    return _lastTime - _firstTime;
+}
+
+/**
+ * Checks whether there are enough observations to estimate the drift and its uncertainty.
+ *
+ * @return True if there are at least RTC_DRIFT_MIN_OBSERVATIONS observations, or false, otherwise.
+ */
+bool DriftEstimator::isEstimateAvailable() const
+{
+    return _count >= RTC_DRIFT_MIN_OBSERVATIONS;
+}
+
+/**
+ * Gets the estimated drift of the device.
+ *
+ * @return The drift, in ppm (positive values mean the device runs fast), or zero if there are less than two
+ *         observations.
+ */
+double DriftEstimator::getDriftPpm() const
+{
+    //The slope is in milliseconds per second
+    return _offsetFit.getSlope() * 1000;
+}
+
+/**
+ * Gets the uncertainty of the estimated drift.
+ *
+ * The uncertainty is the standard error of the slope of the fit: the true drift is within twice this value of the
+ * estimate with about 95% confidence.
+ *
+ * @return The standard error of the drift, in ppm, or zero if isEstimateAvailable() is false.
+ */
+double DriftEstimator::getUncertaintyPpm() const
+{
+    if (!isEstimateAvailable() || _offsetFit.sumXX <= 0)
+    {
+        return 0;
+    }
+
+    double residual = _offsetFit.sumYY - _offsetFit.sumXY * _offsetFit.sumXY / _offsetFit.sumXX;
+    if (residual < 0)
+    {
+        residual = 0;
+    }
+    return sqrt(residual / (_count - 2) / _offsetFit.sumXX) * 1000;
+}
+
+/**
+ * Gets how much the drift changes with the temperature.
+ *
+ * This is the slope of the drift between consecutive observations against their mean temperature. It is meaningful
+ * only if the observations cover a range of temperatures.
+ *
+ * @return The change of the drift, in ppm per degree Celsius, or zero if all intervals had the same temperature.
+ */
+double DriftEstimator::getTemperatureCoefficient() const
+{
+    return _temperatureFit.getSlope();
+}
+
+/**
+ * Gets the mean temperature of the observations.
+ *
+ * @return The mean temperature, in quarters of a degree Celsius, or zero if there are no observations.
+ */
+int16_t DriftEstimator::getMeanTemperature() const
+{
+    return (_count > 0) ? (int16_t)(_temperatureSum / _count) : 0;
+}
+
+/**
+ * Calculates the aging offset that cancels the estimated drift.
+ *
+ * @param currentOffset The value of the aging offset register during the observations.
+ * @return              The recommended value of the aging offset register.
+ */
+int8_t DriftEstimator::recommendAgingOffset(int8_t currentOffset) const
+{
+    double steps = getDriftPpm() * 1000 / RTC_DRIFT_AGING_PPB;
+    int32_t recommended = currentOffset + (int32_t)(steps < 0 ? steps - 0.5 : steps + 0.5);
+
+    if (recommended > 127)
+    {
+        return 127;
+    }
+    if (recommended < -128)
+    {
+        return -128;
+    }
+    return (int8_t)recommended;
+}
+
+/**
+ * Writes the recommended aging offset into the device, if the estimate is good enough.
+ *
+ * A temperature conversion is forced, so the new offset takes effect at once (if a conversion is in progress, it
+ * takes effect in the next automatic one). Then, all observations are discarded, since they describe the previous
+ * frequency.
+ *
+ * @param clock                 The clock of the observed device (see observe()).
+ * @param maximumUncertaintyPpm The maximum uncertainty of the drift, in ppm.
+ * @return                      True if a new aging offset was written, or false if the estimate is not available,
+ *                              the uncertainty is too large, the current offset is already the recommended one or
+ *                              the I2C transfer failed.
+ */
+bool DriftEstimator::applyAgingOffset(RealTimeClock& clock, double maximumUncertaintyPpm)
+{
+    if (!isEstimateAvailable() || getUncertaintyPpm() > maximumUncertaintyPpm)
+    {
+        return false;
+    }
+
+    RealTimeClockController controller(clock.getDevice());
+    int8_t currentOffset;
+    if (!controller.readCalibration(currentOffset))
+    {
+        return false;
+    }
+
+    int8_t recommended = recommendAgingOffset(currentOffset);
+    if (recommended == currentOffset || !controller.writeCalibration(recommended))
+    {
+        return false;
+    }
+
+    clock.forceTemperatureUpdate();
+    reset();
+    return true;
+}
+
+/**
+ * Discards all points of the fit.
+ */
+void DriftEstimator::Regression::reset()
+{
+    weight = 0;
+    meanX  = 0;
+    meanY  = 0;
+    sumXX  = 0;
+    sumXY  = 0;
+    sumYY  = 0;
+}
+
+/**
+ * Adds a point to the fit.
+ *
+ * @param x The independent variable.
+ * @param y The dependent variable.
+ * @param w The weight of the point (greater than zero).
+ */
+void DriftEstimator::Regression::add(double x, double y, double w)
+{
+    weight += w;
+    double deltaX = x - meanX;
+    double deltaY = y - meanY;
+    meanX += deltaX * w / weight;
+    meanY += deltaY * w / weight;
+    sumXX += w * deltaX * (x - meanX);
+    sumXY += w * deltaX * (y - meanY);
+    sumYY += w * deltaY * (y - meanY);
+}
+
+/**
+ * Gets the slope of the fitted line.
+ *
+ * @return The slope, or zero if all points have the same x.
+ */
+double DriftEstimator::Regression::getSlope() const
+{
+    return (sumXX > 0) ? sumXY / sumXX : 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_DRIFT_ESTIMATOR_H__
+#define __AMPLIAR_DS3231_DRIFT_ESTIMATOR_H__
+
+#include <stdint.h>
+#include "RealTimeClock.h"
+#include "RealTimeClockController.h"
+
+namespace Ampliar { namespace DS3231 {
+
+#define RTC_DRIFT_AGING_PPB         100  ///< Frequency change caused by one LSB of the aging offset, in ppb (typical)
+#define RTC_DRIFT_MIN_OBSERVATIONS  3    ///< Minimum number of observations to estimate the drift and its uncertainty
+#define RTC_DRIFT_MAX_UNCERTAINTY   0.05 ///< Default maximum uncertainty to apply an aging offset, in ppm (half LSB)
+
+/**
+ * Estimates the long-term frequency error of DS3231 against a reference clock and recommends an aging offset.
+ *
+ * Each observation is the time of the device and the time of a reference (e.g., NTP or GPS) taken at the same moment,
+ * along with the temperature. The offset between both clocks is fitted to a straight line by least squares, whose slope
+ * is the drift. The fit is updated incrementally (Welford's method), so the memory used does not depend on the number
+ * of observations and the estimator runs both on the device and on a host.
+ *
+ * The drift is reported in ppm (positive values mean the device runs fast), along with the standard error of the
+ * slope. Since one LSB of the aging offset register changes the frequency by about 0.1 ppm (positive values slow the
+ * oscillator), the recommended offset is the current one plus the drift in tenths of ppm. applyAgingOffset() writes it
+ * only when the uncertainty is small enough, then starts a new fit, since the older observations no longer describe
+ * the new frequency.
+ *
+ * The drift between consecutive observations is also fitted against their mean temperature, which estimates how much
+ * of the drift the temperature compensation leaves behind (see getTemperatureCoefficient()). The aging offset is a
+ * single value for all temperatures, so it corrects the drift at the mean temperature of the observations.
+ *
+ * The fits use double, which is a 32-bit float on 8-bit AVR boards: there, keep the span of a fit within a few months.
+ *
+ * @author Daniel Murari Boatto
+ */
+class DriftEstimator
+{
+public:
+    DriftEstimator();
+    void reset();
+    bool addObservation(uint32_t rtcTime, uint32_t referenceTime, int16_t quarterDegrees);
+    bool addOffset(uint32_t referenceTime, int32_t offsetMillis, int16_t quarterDegrees);
+    bool observe(RealTimeClock& clock, uint32_t referenceTime);
+    //
+    uint16_t getObservationCount() const;
+    uint32_t getSpan() const;
+    bool isEstimateAvailable() const;
+    double getDriftPpm() const;
+    double getUncertaintyPpm() const;
+    double getTemperatureCoefficient() const;
+    int16_t getMeanTemperature() const;
+    //
+    int8_t recommendAgingOffset(int8_t currentOffset) const;
+    bool applyAgingOffset(RealTimeClock& clock, double maximumUncertaintyPpm = RTC_DRIFT_MAX_UNCERTAINTY);
+
+private:
+    /**
+     * Incremental weighted least-squares fit of y = a + b * x (West's weighted variant of Welford's method).
+     */
+    struct Regression
+    {
+        double weight;  ///< Sum of the weights
+        double meanX;   ///< Weighted mean of x
+        double meanY;   ///< Weighted mean of y
+        double sumXX;   ///< Weighted sum of squared deviations of x
+        double sumXY;   ///< Weighted sum of the products of the deviations of x and y
+        double sumYY;   ///< Weighted sum of squared deviations of y
+
+        void reset();
+        void add(double x, double y, double w);
+        double getSlope() const;
+    };
+
+    /**
+     * Fit of the offset (in milliseconds) against the reference time (in seconds since the first observation).
+     */
+    Regression _offsetFit;
+
+    /**
+     * Fit of the drift between consecutive observations (in ppm) against their mean temperature (in degrees Celsius),
+     * weighted by the time between them.
+     */
+    Regression _temperatureFit;
+
+    /**
+     * Reference time of the first observation.
+     */
+    uint32_t _firstTime;
+
+    /**
+     * Reference time of the last observation.
+     */
+    uint32_t _lastTime;
+
+    /**
+     * Offset of the last observation, in milliseconds.
+     */
+    int32_t _lastOffset;
+
+    /**
+     * Temperature of the last observation, in quarters of a degree Celsius.
+     */
+    int16_t _lastTemperature;
+
+    /**
+     * Number of observations in the fit.
+     */
+    uint16_t _count;
+
+    /**
+     * Sum of the temperatures of the observations, in quarters of a degree Celsius.
+     */
+    int32_t _temperatureSum;
+};
+
+}} //end of namespace
+#endif //__AMPLIAR_DS3231_DRIFT_ESTIMATOR_H__
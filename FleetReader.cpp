@@ -0,0 +1,186 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "FleetReader.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+using namespace Ampliar::DS3231;
+
+/**
+ * Creates a reader without devices.
+ */
+FleetReader::FleetReader():
+    _deviceCount(0), _busCount(0)
+{
+    //
+}
+
+/**
+ * Adds a device to the fleet.
+ *
+ * @param device The device. It must remain valid while this object exists.
+ * @return       True if the device was added, or false if there are already RTC_FLEET_CAPACITY devices, or
+ *               RTC_FLEET_MAX_BUSES buses and the device is on another one.
+ */
+bool FleetReader::add(Device& device)
+{
+    if (_deviceCount == RTC_FLEET_CAPACITY)
+    {
+        return false;
+    }
+
+    uint8_t busIndex = 0;
+    while (busIndex < _busCount && _workers[busIndex].bus != device.getTransport())
+    {
+        busIndex++;
+    }
+    if (busIndex == _busCount)
+    {
+        if (_busCount == RTC_FLEET_MAX_BUSES)
+        {
+            return false;
+        }
+        _workers[busIndex].reader    = this;
+        _workers[busIndex].bus       = device.getTransport();
+        _workers[busIndex].busIndex  = busIndex;
+        _workers[busIndex].readCount = 0;
+        _busCount++;
+    }
+
+    _devices[_deviceCount]    = &device;
+    _busIndexes[_deviceCount] = busIndex;
+    _valid[_deviceCount]      = false;
+    _deviceCount++;
+    return true;
+}
+
+/**
+ * Reads all devices, with one thread per bus, and waits for all of them.
+ *
+ * If a thread cannot be created, the devices of its bus are read by the calling thread after the other buses were
+ * started, so the sweep still completes.
+ *
+ * @return The number of devices read successfully.
+ */
+uint8_t FleetReader::sweep()
+{
+    bool started[RTC_FLEET_MAX_BUSES];
+    for (uint8_t i = 0; i < _busCount; i++)
+    {
+        started[i] = pthread_create(&_workers[i].thread, 0, run, &_workers[i]) == 0;
+    }
+
+    uint8_t readCount = 0;
+    for (uint8_t i = 0; i < _busCount; i++)
+    {
+        if (started[i])
+        {
+            pthread_join(_workers[i].thread, 0);
+        }
+        else
+        {
+            readBus(_workers[i]);
+        }
+        readCount += _workers[i].readCount;
+    }
+    return readCount;
+}
+
+/**
+ * Gets the number of devices in the fleet.
+ *
+ * @return The number of devices.
+ */
+uint8_t FleetReader::getDeviceCount() const
+{
+    return _deviceCount;
+}
+
+/**
+ * Gets the number of distinct buses, which is the number of threads of a sweep.
+ *
+ * @return The number of buses.
+ */
+uint8_t FleetReader::getBusCount() const
+{
+    return _busCount;
+}
+
+/**
+ * Gets a device of the fleet.
+ *
+ * @param index The index of the device, in the order it was added.
+ * @return      The device.
+ */
+Device& FleetReader::getDevice(uint8_t index) const
+{
+    return *_devices[index];
+}
+
+/**
+ * Checks whether a device was read successfully in the last sweep.
+ *
+ * @param index The index of the device, in the order it was added.
+ * @return      True if its snapshot is valid, or false, otherwise.
+ */
+bool FleetReader::isValid(uint8_t index) const
+{
+    return _valid[index];
+}
+
+/**
+ * Gets the registers read from a device in the last sweep.
+ *
+ * @param index The index of the device, in the order it was added.
+ * @return      The snapshot of the registers (see isValid()).
+ */
+const RegisterSnapshot& FleetReader::getSnapshot(uint8_t index) const
+{
+    return _snapshots[index];
+}
+
+/**
+ * Reads the devices of a bus, in the order they were added.
+ *
+ * @param worker The worker of the bus.
+ */
+void FleetReader::readBus(Worker& worker)
+{
+    worker.readCount = 0;
+    for (uint8_t i = 0; i < _deviceCount; i++)
+    {
+        if (_busIndexes[i] == worker.busIndex)
+        {
+            _valid[i] = _devices[i]->readSnapshot(_snapshots[i]);
+            worker.readCount += _valid[i];
+        }
+    }
+}
+
+/**
+ * Entry point of the worker threads.
+ *
+ * @param worker The worker of the bus.
+ * @return       Null.
+ */
+void* FleetReader::run(void* worker)
+{
+    Worker* self = static_cast<Worker*>(worker);
+    self->reader->readBus(*self);
+    return 0;
+}
+
+#endif //__linux__
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_FLEET_READER_H__
+#define __AMPLIAR_DS3231_FLEET_READER_H__
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <stdint.h>
+#include <pthread.h>
+#include "Device.h"
+#include "RegisterSnapshot.h"
+
+namespace Ampliar { namespace DS3231 {
+
+#ifndef RTC_FLEET_CAPACITY
+#define RTC_FLEET_CAPACITY 64 ///< Maximum number of devices, up to 255 (it can be defined beforehand)
+#endif
+
+#ifndef RTC_FLEET_MAX_BUSES
+#define RTC_FLEET_MAX_BUSES 8 ///< Maximum number of distinct buses (it can be defined beforehand)
+#endif
+
+/**
+ * Reads the register file of many devices, with one thread per bus.
+ *
+ * Transactions on the same bus are serialized by the bus itself, but different buses work in parallel. Thus, sweep()
+ * groups the devices by bus (BusTransport) and starts one worker thread per bus, which reads the devices of its bus
+ * one after another. A sweep takes as long as the slowest bus, instead of the sum of all of them.
+ *
+ * Each device is read with Device::readSnapshot(), a single transaction of 19 bytes from which the date/time, the
+ * alarms, the flags and the temperature can be decoded (see RegisterSnapshot). Devices behind multiplexers are read in
+ * the order they were added, so adding them grouped by multiplexer channel avoids redundant selects.
+ *
+ * The devices, their multiplexers and their transports must not be used by other threads during a sweep.
+ *
+ * @author Daniel Murari Boatto
+ */
+class FleetReader
+{
+public:
+    FleetReader();
+    bool add(Device& device);
+    uint8_t sweep();
+    //
+    uint8_t getDeviceCount() const;
+    uint8_t getBusCount() const;
+    Device& getDevice(uint8_t index) const;
+    bool isValid(uint8_t index) const;
+    const RegisterSnapshot& getSnapshot(uint8_t index) const;
+
+private:
+    /**
+     * Worker that reads the devices of a bus.
+     */
+    struct Worker
+    {
+        FleetReader* reader; ///< Reader that owns the worker
+        BusTransport* bus;   ///< Bus of the devices read by the worker
+        uint8_t busIndex;    ///< Index of the bus
+        uint8_t readCount;   ///< Number of devices read successfully in the last sweep
+        pthread_t thread;    ///< Thread of the worker
+    };
+
+    FleetReader(const FleetReader&);
+    FleetReader& operator=(const FleetReader&);
+    void readBus(Worker& worker);
+    static void* run(void* worker);
+
+    /**
+     * Devices, in the order they were added.
+     */
+    Device* _devices[RTC_FLEET_CAPACITY];
+
+    /**
+     * Index of the bus (worker) of each device.
+     */
+    uint8_t _busIndexes[RTC_FLEET_CAPACITY];
+
+    /**
+     * Registers read from each device in the last sweep.
+     */
+    RegisterSnapshot _snapshots[RTC_FLEET_CAPACITY];
+
+    /**
+     * True if the device was read successfully in the last sweep.
+     */
+    bool _valid[RTC_FLEET_CAPACITY];
+
+    /**
+     * One worker per distinct bus.
+     */
+    Worker _workers[RTC_FLEET_MAX_BUSES];
+
+    /**
+     * Number of devices.
+     */
+    uint8_t _deviceCount;
+
+    /**
+     * Number of distinct buses.
+     */
+    uint8_t _busCount;
+};
+
+}} //end of namespace
+
+#endif //__linux__
+#endif //__AMPLIAR_DS3231_FLEET_READER_H__
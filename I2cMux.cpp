@@ -0,0 +1,139 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "I2cMux.h"
+
+using namespace Ampliar::DS3231;
+
+/**
+ * Constructor.
+ *
+ * @param transport The bus of the multiplexer. It must remain valid while this object exists.
+ * @param address   The I2C address of the multiplexer.
+ * @param group     The first multiplexer created on the same bus, if any. It must remain valid while this object
+ *                  exists.
+ */
+I2cMux::I2cMux(BusTransport& transport, uint8_t address, I2cMux* group):
+    _transport(transport), _next(0), _group(this), _address(address), _channels(0), _known(false), _selectCount(0)
+{
+    if (group)
+    {
+        _group        = group->_group;
+        _next         = _group->_next;
+        _group->_next = this;
+    }
+}
+
+/**
+ * Enables a channel, and only it.
+ *
+ * The other multiplexers of the group are disabled first, unless they are known to be disabled already. Nothing is
+ * written if the channel is known to be the only one enabled.
+ *
+ * @param channel The channel (from 0 to 7).
+ * @return        True if successful or false, otherwise.
+ */
+bool I2cMux::select(uint8_t channel)
+{
+    for (I2cMux* mux = _group; mux; mux = mux->_next)
+    {
+        if (mux != this && (!mux->_known || mux->_channels != 0) && !mux->disable())
+        {
+            return false;
+        }
+    }
+
+    uint8_t channels = 1 << channel;
+    if (_known && _channels == channels)
+    {
+        return true;
+    }
+    return writeChannels(channels);
+}
+
+/**
+ * Disables all channels.
+ *
+ * @return True if successful or false, otherwise.
+ */
+bool I2cMux::disable()
+{
+    return writeChannels(0);
+}
+
+/**
+ * Discards the cached state, so the next selection writes the control register.
+ */
+void I2cMux::invalidate()
+{
+    _known = false;
+}
+
+/**
+ * Gets the bus of the multiplexer.
+ *
+ * @return The bus transport.
+ */
+BusTransport& I2cMux::getTransport() const
+{
+    return _transport;
+}
+
+/**
+ * Gets the I2C address of the multiplexer.
+ *
+ * @return The I2C address.
+ */
+uint8_t I2cMux::getAddress() const
+{
+    return _address;
+}
+
+/**
+ * Checks whether a channel is known to be the only one enabled. This method does not access the bus.
+ *
+ * @param channel The channel (from 0 to 7).
+ * @return        True if it is selected, or false, otherwise.
+ */
+bool I2cMux::isSelected(uint8_t channel) const
+{
+    return _known && _channels == (1 << channel);
+}
+
+/**
+ * Gets the number of writes to the control register, which is how many selections were not skipped.
+ *
+ * @return The number of writes since the object was created.
+ */
+uint32_t I2cMux::getSelectCount() const
+{
+    return _selectCount;
+}
+
+/**
+ * Writes the control register.
+ *
+ * If the write fails, the state of the multiplexer becomes unknown.
+ *
+ * @param channels The channels to enable (bit N enables channel N).
+ * @return         True if successful or false, otherwise.
+ */
+bool I2cMux::writeChannels(uint8_t channels)
+{
+    _selectCount++;
+    _known    = _transport.write(_address, &channels, 1);
+    _channels = channels;
+    return _known;
+}
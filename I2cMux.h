@@ -0,0 +1,99 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_I2C_MUX_H__
+#define __AMPLIAR_DS3231_I2C_MUX_H__
+
+#include <stdint.h>
+#include "BusTransport.h"
+
+namespace Ampliar { namespace DS3231 {
+
+#define RTC_ADDR_MUX     0x70 ///< Default I2C address of TCA9548A (from 0x70 to 0x77)
+#define RTC_MUX_CHANNELS 8    ///< Number of channels of TCA9548A
+
+/**
+ * TCA9548A (or PCA9548A) 8-channel I2C multiplexer.
+ *
+ * Since every DS3231 has the same I2C address, several of them can only share a bus behind a multiplexer. A Device
+ * bound to a channel selects it before each transaction. The selected channel is cached, so consecutive transactions
+ * on the same channel do not write the control register of the multiplexer again.
+ *
+ * When several multiplexers share a bus, only one of them may have a channel enabled, otherwise the devices behind
+ * both would answer at once. Such multiplexers form a group: the first one is created alone, and the others receive
+ * it as group. Selecting a channel disables the channels of the other multiplexers of the group first (only if they
+ * may be enabled, according to their cache).
+ *
+ * The cache starts unknown, so the first selection always writes. If another master (or a reset) may have changed the
+ * multiplexer, call invalidate().
+ *
+ * @author Daniel Murari Boatto
+ */
+class I2cMux
+{
+public:
+    explicit I2cMux(BusTransport& transport, uint8_t address = RTC_ADDR_MUX, I2cMux* group = 0);
+    bool select(uint8_t channel);
+    bool disable();
+    void invalidate();
+    //
+    BusTransport& getTransport() const;
+    uint8_t getAddress() const;
+    bool isSelected(uint8_t channel) const;
+    uint32_t getSelectCount() const;
+
+private:
+    I2cMux(const I2cMux&);
+    I2cMux& operator=(const I2cMux&);
+    bool writeChannels(uint8_t channels);
+
+    /**
+     * Bus of the multiplexer.
+     */
+    BusTransport& _transport;
+
+    /**
+     * Next multiplexer of the group (null if this is the last one).
+     */
+    I2cMux* _next;
+
+    /**
+     * First multiplexer of the group (this one, if it was created alone).
+     */
+    I2cMux* _group;
+
+    /**
+     * I2C address of the multiplexer.
+     */
+    uint8_t _address;
+
+    /**
+     * Last value written to the control register (bit N enables channel N).
+     */
+    uint8_t _channels;
+
+    /**
+     * True if _channels matches the control register of the multiplexer.
+     */
+    bool _known;
+
+    /**
+     * Number of writes to the control register.
+     */
+    uint32_t _selectCount;
+};
+
+}} //end of namespace
+#endif //__AMPLIAR_DS3231_I2C_MUX_H__
@@ -0,0 +1,169 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "LinuxI2cTransport.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c-dev.h>
+
+using namespace Ampliar::DS3231;
+
+/**
+ * Constructor.
+ *
+ * The character device is only opened when begin() is called (BaseClock::setTransport() calls it).
+ *
+ * @param path Path of the i2c-dev character device, like "/dev/i2c-1". It must remain valid while this object exists.
+ */
+LinuxI2cTransport::LinuxI2cTransport(const char* path):
+    _path(path), _fd(-1), _ownsFd(false)
+{
+    //
+}
+
+/**
+ * Constructor.
+ *
+ * This constructor uses a file descriptor already opened by the caller, who remains responsible for closing it.
+ *
+ * @param fd File descriptor of an i2c-dev character device.
+ */
+LinuxI2cTransport::LinuxI2cTransport(int fd):
+    _path(0), _fd(fd), _ownsFd(false)
+{
+    //
+}
+
+/**
+ * Destructor.
+ *
+ * It closes the character device if it was opened by this object.
+ */
+LinuxI2cTransport::~LinuxI2cTransport()
+{
+    end();
+}
+
+/**
+ * Opens the character device.
+ *
+ * It does nothing if the device is already open.
+ */
+void LinuxI2cTransport::begin()
+{
+    if (_fd >= 0 || _path == 0)
+    {
+        return;
+    }
+
+    _fd = open(_path, O_RDWR | O_CLOEXEC);
+    _ownsFd = _fd >= 0;
+}
+
+/**
+ * Closes the character device if it was opened by this object.
+ */
+void LinuxI2cTransport::end()
+{
+    if (_ownsFd)
+    {
+        close(_fd);
+        _fd = -1;
+        _ownsFd = false;
+    }
+}
+
+/**
+ * Checks whether the character device is open or not.
+ *
+ * @return True if it is open.
+ */
+bool LinuxI2cTransport::isOpen() const
+{
+    return _fd >= 0;
+}
+
+/**
+ * Writes bytes to a device in a single I2C_RDWR ioctl.
+ *
+ * @param address The I2C address of the device.
+ * @param data    The bytes to be written.
+ * @param length  The number of bytes.
+ * @return        True if successful or false, otherwise.
+ */
+bool LinuxI2cTransport::write(uint8_t address, const uint8_t* data, uint8_t length)
+{
+    struct i2c_msg message;
+    message.addr  = address;
+    message.flags = 0;
+    message.len   = length;
+    message.buf   = const_cast<uint8_t*>(data);
+
+    return transfer(&message, 1);
+}
+
+/**
+ * Writes bytes to a device and then reads its answer in a single I2C_RDWR ioctl.
+ *
+ * The kernel issues a repeated START between the two messages.
+ *
+ * @param address  The I2C address of the device.
+ * @param tx       The bytes to be written (usually the register address).
+ * @param txLength The number of bytes to be written.
+ * @param rx       The buffer that will receive the bytes read.
+ * @param rxLength The number of bytes to be read.
+ * @return         True if successful or false, otherwise.
+ */
+bool LinuxI2cTransport::writeRead(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength)
+{
+    struct i2c_msg messages[2];
+    messages[0].addr  = address;
+    messages[0].flags = 0;
+    messages[0].len   = txLength;
+    messages[0].buf   = const_cast<uint8_t*>(tx);
+    messages[1].addr  = address;
+    messages[1].flags = I2C_M_RD;
+    messages[1].len   = rxLength;
+    messages[1].buf   = rx;
+
+    return transfer(messages, 2);
+}
+
+/**
+ * Executes I2C messages as a combined transaction.
+ *
+ * @param messages The messages.
+ * @param count    The number of messages.
+ * @return         True if successful or false, otherwise.
+ */
+bool LinuxI2cTransport::transfer(struct i2c_msg* messages, uint32_t count)
+{
+    if (_fd < 0)
+    {
+        return false;
+    }
+
+    struct i2c_rdwr_ioctl_data data;
+    data.msgs  = messages;
+    data.nmsgs = count;
+
+    return ioctl(_fd, I2C_RDWR, &data) == (int)count;
+}
+
+#endif //__linux__
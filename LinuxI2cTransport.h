@@ -0,0 +1,78 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_LINUX_I2C_TRANSPORT_H__
+#define __AMPLIAR_DS3231_LINUX_I2C_TRANSPORT_H__
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <stdint.h>
+#include <linux/i2c.h>
+#include "BusTransport.h"
+
+namespace Ampliar { namespace DS3231 {
+
+/**
+ * Bus transport based on the Linux i2c-dev interface.
+ *
+ * This transport talks to the device through a character device like /dev/i2c-1. Every transaction is issued as a
+ * single I2C_RDWR ioctl: a register read is a write message followed by a read message with a repeated START, and a
+ * burst write (e.g., the date/time or an alarm) is a single write message. Thus, each transaction costs one system call
+ * and no STOP condition is generated between the register address and the data.
+ *
+ * It can be used with the i2c-stub kernel module, or with a file descriptor provided by the caller. Subclasses may
+ * override transfer() to replace the ioctl (e.g., to test against an in-memory device).
+ *
+ * @author Daniel Murari Boatto
+ */
+class LinuxI2cTransport : public BusTransport
+{
+public:
+    explicit LinuxI2cTransport(const char* path);
+    explicit LinuxI2cTransport(int fd);
+    ~LinuxI2cTransport();
+    void begin();
+    void end();
+    bool isOpen() const;
+    bool write(uint8_t address, const uint8_t* data, uint8_t length);
+    bool writeRead(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength);
+
+protected:
+    virtual bool transfer(struct i2c_msg* messages, uint32_t count);
+
+private:
+    LinuxI2cTransport(const LinuxI2cTransport&);
+    LinuxI2cTransport& operator=(const LinuxI2cTransport&);
+
+    /**
+     * Path of the character device (null if the descriptor was provided by the caller).
+     */
+    const char* _path;
+
+    /**
+     * File descriptor of the character device (-1 if closed).
+     */
+    int _fd;
+
+    /**
+     * Indicates whether this object opened (and therefore must close) the file descriptor.
+     */
+    bool _ownsFd;
+};
+
+}} //end of namespace
+
+#endif //__linux__
+#endif //__AMPLIAR_DS3231_LINUX_I2C_TRANSPORT_H__
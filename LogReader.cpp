@@ -0,0 +1,224 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "LogReader.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace Ampliar::DS3231;
+
+/**
+ * Creates a reader without a log (see open()).
+ */
+LogReader::LogReader():
+    _data(0), _length(0), _mapped(false), _position(0), _blockEnd(0), _remaining(0), _lastTime(0), _lastDelta(0),
+    _skipped(0)
+{
+    //
+}
+
+/**
+ * Creates a reader of a log in memory.
+ *
+ * @param data   The log. It must remain valid while this object exists.
+ * @param length The size of the log, in bytes.
+ */
+LogReader::LogReader(const uint8_t* data, size_t length):
+    _data(data), _length(length), _mapped(false), _position(0), _blockEnd(0), _remaining(0), _lastTime(0),
+    _lastDelta(0), _skipped(0)
+{
+    //
+}
+
+/**
+ * Destructor. It unmaps the file, if any.
+ */
+LogReader::~LogReader()
+{
+    close();
+}
+
+/**
+ * Maps a log file and positions the reader at its first record.
+ *
+ * @param path The path of the file.
+ * @return     True if the file was mapped (or is empty), or false if it could not be opened.
+ */
+bool LogReader::open(const char* path)
+{
+    close();
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat status;
+    bool opened = fstat(fd, &status) == 0;
+    if (opened && status.st_size > 0)
+    {
+        void* memory = mmap(0, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        opened = memory != MAP_FAILED;
+        if (opened)
+        {
+            madvise(memory, status.st_size, MADV_SEQUENTIAL);
+            _data   = static_cast<const uint8_t*>(memory);
+            _length = status.st_size;
+            _mapped = true;
+        }
+    }
+    ::close(fd);
+    return opened;
+}
+
+/**
+ * Unmaps the log file, if any. Afterwards, the reader has no log.
+ */
+void LogReader::close()
+{
+    if (_mapped)
+    {
+        munmap(const_cast<uint8_t*>(_data), _length);
+        _mapped = false;
+    }
+    _data   = 0;
+    _length = 0;
+    rewind();
+}
+
+/**
+ * Reads the next record.
+ *
+ * @param record The object that receives the record.
+ * @return       True if a record was read, or false at the end of the log.
+ */
+bool LogReader::next(LogRecord& record)
+{
+    while (true)
+    {
+        if (_remaining == 0 && !nextBlock())
+        {
+            return false;
+        }
+
+        uint32_t value = 0;
+        uint8_t shift  = 0;
+        uint8_t byte   = 0x80;
+        while ((byte & 0x80) && shift < 35 && _position < _blockEnd)
+        {
+            byte   = _data[_position++];
+            value |= (uint32_t)(byte & 0x7F) << shift;
+            shift += 7;
+        }
+        if ((byte & 0x80) || _blockEnd - _position < 2)
+        {
+            //Incomplete record: the rest of the block is unusable
+            _remaining = 0;
+            _position  = _blockEnd;
+            continue;
+        }
+
+        _lastDelta = (int32_t)((uint32_t)_lastDelta + (uint32_t)SampleLog::unzigzag(value));
+        _lastTime += _lastDelta;
+        uint16_t word = _data[_position] | (_data[_position + 1] << 8);
+        _position += 2;
+        _remaining--;
+
+        record.unixTime       = _lastTime;
+        record.quarterDegrees = (int16_t)(word << 6) >> 6; //sign extension of the lower 10 bits
+        record.flags          = word >> 10;
+        return true;
+    }
+}
+
+/**
+ * Positions the reader at the first record of the log again.
+ */
+void LogReader::rewind()
+{
+    _position  = 0;
+    _blockEnd  = 0;
+    _remaining = 0;
+    _skipped   = 0;
+}
+
+/**
+ * Gets the log.
+ *
+ * @return The log (null if there is none).
+ */
+const uint8_t* LogReader::getData() const
+{
+    return _data;
+}
+
+/**
+ * Gets the size of the log.
+ *
+ * @return The number of bytes of the log.
+ */
+size_t LogReader::getLength() const
+{
+    return _length;
+}
+
+/**
+ * Gets the number of bytes skipped because they were not part of a valid block.
+ *
+ * @return The number of bytes skipped since the log was opened or rewound.
+ */
+size_t LogReader::getSkippedBytes() const
+{
+    return _skipped;
+}
+
+/**
+ * Finds the next block header, from the end of the current block.
+ *
+ * @return True if a block was found, or false at the end of the log.
+ */
+bool LogReader::nextBlock()
+{
+    _position = _blockEnd > _position ? _blockEnd : _position;
+    while (_position + RTC_LOG_HEADER_SIZE <= _length)
+    {
+        const uint8_t* header = _data + _position;
+        if (header[0] == RTC_LOG_MAGIC0 && header[1] == RTC_LOG_MAGIC1 && header[2] == RTC_LOG_VERSION
+            && header[3] > 0)
+        {
+            size_t size = header[4] | (header[5] << 8);
+            _position += RTC_LOG_HEADER_SIZE;
+            _blockEnd  = _length - _position < size ? _length : _position + size;
+            _remaining = header[3];
+            _lastTime  = header[6] | (header[7] << 8) | (header[8] << 16) | ((uint32_t)header[9] << 24);
+            _lastDelta = 0;
+            return true;
+        }
+        _position++;
+        _skipped++;
+    }
+
+    _skipped  += _length - _position;
+    _position  = _length;
+    _blockEnd  = _length;
+    return false;
+}
+
+#endif //__linux__
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_LOG_READER_H__
+#define __AMPLIAR_DS3231_LOG_READER_H__
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <stdint.h>
+#include <stddef.h>
+#include "SampleLog.h"
+
+namespace Ampliar { namespace DS3231 {
+
+/**
+ * Reader of sample logs (see SampleLog.h) written by LogWriter.
+ *
+ * The log is read in place: open() maps the file read-only and next() decodes the records directly from the mapping
+ * (or from memory provided by the caller), with no copies and no allocation, so reading is limited by I/O.
+ *
+ * Damaged data between blocks is skipped up to the next valid header (see getSkippedBytes()). The last block may be
+ * incomplete (e.g., the writer lost power while writing it): its complete records are read.
+ *
+ * ~~~~~~~~~~~~~~~{.cpp}
+ * LogReader log;
+ * LogRecord record;
+ * if (log.open("samples.log")) {
+ *     while (log.next(record)) { ... }
+ * }
+ * ~~~~~~~~~~~~~~~
+ *
+ * @author Daniel Murari Boatto
+ */
+class LogReader
+{
+public:
+    LogReader();
+    LogReader(const uint8_t* data, size_t length);
+    ~LogReader();
+    bool open(const char* path);
+    void close();
+    bool next(LogRecord& record);
+    void rewind();
+    //
+    const uint8_t* getData() const;
+    size_t getLength() const;
+    size_t getSkippedBytes() const;
+
+private:
+    LogReader(const LogReader&);
+    LogReader& operator=(const LogReader&);
+    bool nextBlock();
+
+    /**
+     * The log.
+     */
+    const uint8_t* _data;
+
+    /**
+     * Size of the log, in bytes.
+     */
+    size_t _length;
+
+    /**
+     * True if the log was mapped by open() (and must be unmapped).
+     */
+    bool _mapped;
+
+    /**
+     * Offset of the next record (or block).
+     */
+    size_t _position;
+
+    /**
+     * Offset of the end of the current block.
+     */
+    size_t _blockEnd;
+
+    /**
+     * Number of records of the current block not read yet.
+     */
+    uint8_t _remaining;
+
+    /**
+     * Time of the last record.
+     */
+    uint32_t _lastTime;
+
+    /**
+     * Interval between the last two records, in seconds.
+     */
+    int32_t _lastDelta;
+
+    /**
+     * Number of bytes that were not part of a valid block.
+     */
+    size_t _skipped;
+};
+
+}} //end of namespace
+
+#endif //__linux__
+#endif //__AMPLIAR_DS3231_LOG_READER_H__
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "LogWriter.h"
+#include "Temperature.h"
+#include "TimeBlock.h"
+
+using namespace Ampliar::DS3231;
+
+/**
+ * Constructor.
+ *
+ * @param buffer The buffer of the block. It must remain valid while this object exists.
+ * @param size   The size of the buffer, at least RTC_LOG_HEADER_SIZE + RTC_LOG_MAX_RECORD bytes.
+ */
+LogWriter::LogWriter(uint8_t* buffer, uint16_t size):
+    _buffer(buffer), _size(size), _length(0), _lastTime(0), _lastDelta(0)
+{
+    //
+}
+
+/**
+ * Appends a record to the block.
+ *
+ * @param unixTime       The number of seconds since 1970-01-01 00:00:00.
+ * @param quarterDegrees The temperature in quarters of a degree Celsius, limited to the range from
+ *                       RTC_LOG_MIN_TEMPERATURE to RTC_LOG_MAX_TEMPERATURE.
+ * @param flags          The flags (see RTC_LOG_FLAG_A1F, RTC_LOG_FLAG_MARK, etc.).
+ * @return               True if the record was appended, or false if the block is full.
+ */
+bool LogWriter::append(uint32_t unixTime, int16_t quarterDegrees, uint8_t flags)
+{
+    if (_length == 0)
+    {
+        if (_size < RTC_LOG_HEADER_SIZE + RTC_LOG_MAX_RECORD)
+        {
+            return false;
+        }
+        _buffer[0] = RTC_LOG_MAGIC0;
+        _buffer[1] = RTC_LOG_MAGIC1;
+        _buffer[2] = RTC_LOG_VERSION;
+        _buffer[3] = 0;
+        _buffer[6] = unixTime;
+        _buffer[7] = unixTime >> 8;
+        _buffer[8] = unixTime >> 16;
+        _buffer[9] = unixTime >> 24;
+        _length    = RTC_LOG_HEADER_SIZE;
+        _lastTime  = unixTime;
+        _lastDelta = 0;
+    }
+    else if (_buffer[3] == RTC_LOG_MAX_RECORDS || _size - _length < RTC_LOG_MAX_RECORD)
+    {
+        return false;
+    }
+
+    //Deltas wrap around modulo 2^32, as the reader does, so any change of the time can be encoded
+    int32_t delta = (int32_t)(unixTime - _lastTime);
+    uint32_t value = SampleLog::zigzag((int32_t)((uint32_t)delta - (uint32_t)_lastDelta));
+    while (value >= 0x80)
+    {
+        _buffer[_length++] = (uint8_t)value | 0x80;
+        value >>= 7;
+    }
+    _buffer[_length++] = (uint8_t)value;
+
+    if (quarterDegrees < RTC_LOG_MIN_TEMPERATURE)
+    {
+        quarterDegrees = RTC_LOG_MIN_TEMPERATURE;
+    }
+    else if (quarterDegrees > RTC_LOG_MAX_TEMPERATURE)
+    {
+        quarterDegrees = RTC_LOG_MAX_TEMPERATURE;
+    }
+    uint16_t word = ((uint16_t)quarterDegrees & 0x03FF) | ((uint16_t)(flags & 0x3F) << 10);
+    _buffer[_length++] = word;
+    _buffer[_length++] = word >> 8;
+
+    _lastTime  = unixTime;
+    _lastDelta = delta;
+    _buffer[3]++;
+    _buffer[4] = _length - RTC_LOG_HEADER_SIZE;
+    _buffer[5] = (_length - RTC_LOG_HEADER_SIZE) >> 8;
+    return true;
+}
+
+/**
+ * Appends a record with the date/time, the temperature and the status flags of a register snapshot, which are read
+ * in a single transaction (see BaseClock::readSnapshot()).
+ *
+ * @param snapshot The registers.
+ * @param flags    Additional flags (e.g., RTC_LOG_FLAG_MARK).
+ * @return         True if the record was appended, or false if the block is full.
+ */
+bool LogWriter::append(const RegisterSnapshot& snapshot, uint8_t flags)
+{
+    const uint8_t* temperature = snapshot.getRegisters(RTC_ADDR_TEMPERATURE);
+    return append(TimeBlock::toUnixTime(snapshot.getRegisters(RTC_ADDR_DATE)),
+                  Temperature::fromRegisters(temperature[0], temperature[1]),
+                  flags | SampleLog::flagsFromStatus(snapshot.getRegister(RTC_ADDR_STATUS)));
+}
+
+/**
+ * Empties the block, usually after it was written. The next record starts a new block.
+ */
+void LogWriter::clear()
+{
+    _length = 0;
+}
+
+/**
+ * Gets the block.
+ *
+ * @return The header and the records of the block (see getLength()).
+ */
+const uint8_t* LogWriter::getData() const
+{
+    return _buffer;
+}
+
+/**
+ * Gets the size of the block.
+ *
+ * @return The number of bytes of the block, or zero if it is empty.
+ */
+uint16_t LogWriter::getLength() const
+{
+    return _length;
+}
+
+/**
+ * Gets the number of records of the block.
+ *
+ * @return The number of records.
+ */
+uint8_t LogWriter::getRecordCount() const
+{
+    return _length ? _buffer[3] : 0;
+}
+
+/**
+ * Checks whether the block has no records.
+ *
+ * @return True if it is empty.
+ */
+bool LogWriter::isEmpty() const
+{
+    return _length == 0;
+}
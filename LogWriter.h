@@ -0,0 +1,90 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_LOG_WRITER_H__
+#define __AMPLIAR_DS3231_LOG_WRITER_H__
+
+#include <stdint.h>
+#include "SampleLog.h"
+#include "RegisterSnapshot.h"
+
+namespace Ampliar { namespace DS3231 {
+
+/**
+ * Writer of sample logs (see SampleLog.h) in a fixed buffer provided by the caller.
+ *
+ * The buffer holds one block: its header is kept up to date by every append(), so getData() and getLength() always
+ * return a complete block that can be written to a file or an SD card at any time (e.g., before sleeping). When the
+ * buffer is full, append() returns false: the block must be written and the buffer cleared before appending again.
+ *
+ * No memory is allocated and no 64-bit arithmetic is used. A buffer of 64 bytes holds 18 samples taken at a steady
+ * rate, and one of 512 bytes (an SD card sector) holds 167.
+ *
+ * ~~~~~~~~~~~~~~~{.cpp}
+ * uint8_t buffer[512];
+ * LogWriter log(buffer, sizeof(buffer));
+ * //...
+ * RegisterSnapshot snapshot;
+ * if (clock.readSnapshot(snapshot) && !log.append(snapshot)) {
+ *     file.write(log.getData(), log.getLength());
+ *     log.clear();
+ *     log.append(snapshot);
+ * }
+ * ~~~~~~~~~~~~~~~
+ *
+ * @author Daniel Murari Boatto
+ */
+class LogWriter
+{
+public:
+    LogWriter(uint8_t* buffer, uint16_t size);
+    bool append(uint32_t unixTime, int16_t quarterDegrees, uint8_t flags);
+    bool append(const RegisterSnapshot& snapshot, uint8_t flags = 0);
+    void clear();
+    //
+    const uint8_t* getData() const;
+    uint16_t getLength() const;
+    uint8_t getRecordCount() const;
+    bool isEmpty() const;
+
+private:
+    /**
+     * Buffer of the block (header and records).
+     */
+    uint8_t* _buffer;
+
+    /**
+     * Size of the buffer, in bytes.
+     */
+    uint16_t _size;
+
+    /**
+     * Number of bytes used in the buffer (zero if the block is empty).
+     */
+    uint16_t _length;
+
+    /**
+     * Time of the last record.
+     */
+    uint32_t _lastTime;
+
+    /**
+     * Interval between the last two records, in seconds.
+     */
+    int32_t _lastDelta;
+};
+
+}} //end of namespace
+#endif //__AMPLIAR_DS3231_LOG_WRITER_H__
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_PLATFORM_H__
+#define __AMPLIAR_DS3231_PLATFORM_H__
+
+/*
+ * Platform abstraction.
+ *
+ * On Arduino, everything comes from Arduino.h. On other platforms (e.g., Linux hosts), this header provides the few
+ * definitions this library needs, so the same source files can be compiled there.
+ *
+ * The library reads the time through getMillis() and getMicros(), which live in its own namespace, so nothing is
+ * added to the global namespace of a host application (which may have its own millis(), e.g., wiringPi).
+ */
+#if defined(ARDUINO)
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <time.h>
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+#ifndef pgm_read_byte
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+#endif
+#endif
+
+namespace Ampliar { namespace DS3231 {
+
+/**
+ * Gets the number of milliseconds since an arbitrary point (like Arduino millis(), it wraps around after ~49 days).
+ *
+ * @return The number of milliseconds.
+ */
+inline uint32_t getMillis()
+{
+#if defined(ARDUINO)
+    return millis();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+#endif
+}
+
+/**
+ * Gets the number of microseconds since an arbitrary point (like Arduino micros(), it wraps around after ~71 minutes).
+ *
+ * @return The number of microseconds.
+ */
+inline uint32_t getMicros()
+{
+#if defined(ARDUINO)
+    return micros();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+#endif
+}
+
+}} //end of namespace
+
+#endif //__AMPLIAR_DS3231_PLATFORM_H__
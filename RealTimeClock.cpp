@@ -13,11 +13,27 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <math.h>
 #include "RealTimeClock.h"
+#include "Device.h"
 
 using namespace Ampliar::DS3231;
 using namespace Ampliar::BinaryHelper;
 
+/**
+ * Constructor.
+ *
+ * This constructor does not read any information from the device. Call readDateTime() before calling any getter.
+ *
+ * @param device The device of the clock (the default device, if omitted).
+ */
+RealTimeClock::RealTimeClock(Device& device):
+    BaseClock(device), _second(0), _minute(0), _day(0), _hour(0), _month(0), _dayOfWeek(0), _year(0),
+    _dateTimeCallback(0), _temperatureCallback(0), _callbackContext(0)
+{
+    //
+}
+
 /**
  * Check if the clock was stopped.
  *
@@ -32,11 +48,12 @@ using namespace Ampliar::BinaryHelper;
  * -# External influences upon the crystal (leakage, coupling, etc.).
  *
  * \b Note: You should only trust on the date/time read if this method returns false.
- * @return True if the clock is stopped or false, otherwise.
+ * @return True if the clock is stopped or the status register could not be read, or false, otherwise.
  */
 bool RealTimeClock::wasItStopped() const
 {
-    return isBitSet(readRegister(RTC_ADDR_STATUS), RTC_REG_STATUS_OSF);
+    uint8_t statusRegister;
+    return !readRegister(RTC_ADDR_STATUS, statusRegister) || isBitSet(statusRegister, RTC_REG_STATUS_OSF);
 }
 
 /**
@@ -66,9 +83,10 @@ void RealTimeClock::writeDateTime(int16_t year, uint8_t month, uint8_t day, uint
     _day       = day;
     _month     = month;
     _year      = year;
-    _dayOfWeek = calculateDayOfWeek(year, month, day) + 1;
+    _dayOfWeek = Calendar::weekday(year, month, day) + 1;
 
-    if (year > 2000)
+    //The device stores the year without century (from 00 to 99) and a century bit
+    if (year >= 2000)
     {
         century = 0x80;
         year -= 2000;
@@ -78,18 +96,69 @@ void RealTimeClock::writeDateTime(int16_t year, uint8_t month, uint8_t day, uint
         year -= 1900;
     }
 
-    Wire.beginTransmission(RTC_ADDR_I2C);
-    Wire.write(RTC_ADDR_DATE);
-    Wire.write(fromDecimalToBcd(second));
-    Wire.write(fromDecimalToBcd(minute));
-    Wire.write(fromDecimalToBcd(hour));
-    Wire.write(fromDecimalToBcd(_dayOfWeek));
-    Wire.write(fromDecimalToBcd(day));
-    Wire.write(fromDecimalToBcd(month) | century);
-    Wire.write(fromDecimalToBcd(year));
-    Wire.endTransmission();
-
-    clearOscillatorStopFlag();
+    uint8_t registers[7];
+    registers[0] = decimalToBcd(second);
+    registers[1] = decimalToBcd(minute);
+    registers[2] = decimalToBcd(hour);
+    registers[3] = decimalToBcd(_dayOfWeek);
+    registers[4] = decimalToBcd(day);
+    registers[5] = decimalToBcd(month) | century;
+    registers[6] = decimalToBcd(year);
+    //the oscillator stop flag must keep warning about the date/time if it was not written
+    if (writeRegisters(RTC_ADDR_DATE, registers, 7))
+    {
+        clearOscillatorStopFlag();
+    }
+}
+
+/**
+ * Stores a given date/time in DS3231 memory, like writeDateTime(int16_t, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t)
+ * does.
+ *
+ * @param dateTime The date/time.
+ */
+void RealTimeClock::writeDateTime(const DateTime& dateTime)
+{
+    writeDateTime(dateTime.getYear(), dateTime.getMonth(), dateTime.getDay(), dateTime.getHour(),
+                  dateTime.getMinute(), dateTime.getSecond());
+}
+
+/**
+ * Reads the date/time from the device as Unix time.
+ *
+ * This method works like readDateTime() (the getters are updated as well), but it also returns the date/time as the
+ * number of seconds since 1970-01-01 00:00:00, assuming that the device keeps UTC.
+ *
+ * \b Note: Unix time can only represent dates from 1970 to 2106.
+ *
+ * @return The number of seconds since 1970-01-01 00:00:00, or zero if the device could not be read.
+ */
+uint32_t RealTimeClock::readUnixTime()
+{
+    if (!readDateTime())
+    {
+        return 0;
+    }
+    return getUnixTime();
+}
+
+/**
+ * Stores a given Unix time in DS3231 memory.
+ *
+ * This method converts the number of seconds since 1970-01-01 00:00:00 to a civil date/time and writes it on DS3231
+ * internal registers, like writeDateTime() does.
+ *
+ * \b Note: The device can only keep dates up to 2099.
+ *
+ * @param time The number of seconds since 1970-01-01 00:00:00.
+ */
+void RealTimeClock::writeUnixTime(uint32_t time)
+{
+    Calendar::CivilDate date = Calendar::civilFromDays(Calendar::daysFromUnixTime(time));
+    uint32_t secondsOfDay    = Calendar::secondsOfDay(time);
+    uint16_t minutesOfDay    = secondsOfDay / 60;
+
+    writeDateTime(date.year, date.month, date.day, minutesOfDay / 60, minutesOfDay % 60, secondsOfDay % 60);
 }
 
 /**
@@ -101,25 +170,141 @@ void RealTimeClock::writeDateTime(int16_t year, uint8_t month, uint8_t day, uint
  * \b Note:
  * - You must call this method before using any getter related to date/time, otherwise they will return zero.
  * - Use the method wasItStopped() to determine if you can thrust on the date/time read from the device.
+ *
+ * @return True if successful, or false if the I2C transfer failed (this object is left unchanged).
+ */
+bool RealTimeClock::readDateTime()
+{
+    uint8_t registers[RTC_TIME_BLOCK_SIZE];
+    if (!readRegisters(RTC_ADDR_DATE, registers, RTC_TIME_BLOCK_SIZE))
+    {
+        return false;
+    }
+
+    decodeDateTime(registers);
+    return true;
+}
+
+/**
+ * Starts reading the date/time from the device, without waiting for the I2C transfer.
+ *
+ * This method returns at once. Call the poll() of the device periodically (BaseClock::poll(), for the default
+ * device): when the transfer finishes, the date/time is stored in this object (like readDateTime() does) and the
+ * callback is called from poll().
+ *
+ * Only one asynchronous read may be pending on each device (see Device::beginAsyncRead()).
+ *
+ * @param callback The function called when the read finishes.
+ * @param context  Argument passed to the callback.
+ * @return         True if the read was started, or false if another read is still pending.
+ */
+bool RealTimeClock::readDateTimeAsync(DateTimeCallback callback, void* context)
+{
+    if (getDevice().isReadPending())
+    {
+        return false;
+    }
+
+    _dateTimeCallback = callback;
+    _callbackContext  = context;
+    return beginAsyncRead(RTC_ADDR_DATE, RTC_TIME_BLOCK_SIZE, onDateTimeRead, this);
+}
+
+/**
+ * Completes an asynchronous date/time read.
+ *
+ * @param owner     The clock that started the read.
+ * @param registers The content of the date/time registers.
+ * @param success   True if the registers were read.
+ */
+void RealTimeClock::onDateTimeRead(BaseClock* owner, const uint8_t* registers, bool success)
+{
+    RealTimeClock* clock = static_cast<RealTimeClock*>(owner);
+    if (success)
+    {
+        clock->decodeDateTime(registers);
+    }
+    clock->_dateTimeCallback(*clock, success, clock->_callbackContext);
+}
+
+/**
+ * Reads the date/time from a snapshot of the registers.
+ *
+ * This method works like readDateTime(), but it decodes the date/time from a snapshot previously read by
+ * BaseClock::readSnapshot(). Therefore, it does not communicate with the device.
+ *
+ * @param snapshot The snapshot of the registers.
+ */
+void RealTimeClock::readDateTime(const RegisterSnapshot& snapshot)
+{
+    decodeDateTime(snapshot.getRegisters(RTC_ADDR_DATE));
+}
+
+/**
+ * Reads the date/time from the device and returns it, without changing this object.
+ *
+ * Unlike readDateTime(), this method does not store the date/time in this object (the getters are not updated), so
+ * a single const clock can be shared by many callers, each one keeping its own DateTime (4 bytes).
+ *
+ * @return The date/time, or an invalid one (see DateTime::isValid()) if the device could not be read or holds a
+ *         date/time out of the range of DateTime.
+ */
+DateTime RealTimeClock::readNow() const
+{
+    uint8_t registers[RTC_TIME_BLOCK_SIZE];
+    if (!readRegisters(RTC_ADDR_DATE, registers, RTC_TIME_BLOCK_SIZE))
+    {
+        return DateTime();
+    }
+    return toDateTime(registers);
+}
+
+/**
+ * Gets the date/time of a snapshot of the registers, without changing this object.
+ *
+ * @param snapshot The snapshot of the registers (see BaseClock::readSnapshot()).
+ * @return         The date/time, or an invalid one (see DateTime::isValid()) if it is out of the range of DateTime.
+ */
+DateTime RealTimeClock::readNow(const RegisterSnapshot& snapshot) const
+{
+    return toDateTime(snapshot.getRegisters(RTC_ADDR_DATE));
+}
+
+/**
+ * Decodes the date/time registers into a DateTime.
+ *
+ * @param registers The content of the 7 (seven) date/time registers, starting at RTC_ADDR_DATE.
+ * @return          The date/time, or an invalid one (see DateTime::isValid()) if it is out of the range of DateTime
+ *                  (e.g., a year of the 20th century).
  */
-void RealTimeClock::readDateTime()
+DateTime RealTimeClock::toDateTime(const uint8_t* registers)
 {
-    Wire.beginTransmission(RTC_ADDR_I2C);
-    Wire.write(RTC_ADDR_DATE);
-    Wire.endTransmission();
-
-    Wire.requestFrom(RTC_ADDR_I2C, 7);
-    _second    = fromBcdToDecimal(Wire.read());
-    _minute    = fromBcdToDecimal(Wire.read());
-    _hour      = fromBcdToDecimal(Wire.read());
-    _dayOfWeek = fromBcdToDecimal(Wire.read());
-    _day       = fromBcdToDecimal(Wire.read());
-
-    uint8_t monthAndCentury = Wire.read();
-
-    _month = fromBcdToDecimal(monthAndCentury & 0x1F);
-    _year  = fromBcdToDecimal(Wire.read());
-    _year += ((monthAndCentury & 0x80) != 0 ? 2000 : 1900);
+    TimeFields fields;
+    TimeBlock::decode(registers, fields);
+    return DateTime(fields.year, fields.month, fields.day, fields.hour, fields.minute, fields.second);
+}
+
+/**
+ * Decodes the date/time registers and stores the values in this object.
+ *
+ * The hours are always stored in 24-hour format, even if the device is in 12-hour mode.
+ *
+ * @see TimeBlock::decode().
+ *
+ * @param registers The content of the 7 (seven) date/time registers, starting at RTC_ADDR_DATE.
+ */
+void RealTimeClock::decodeDateTime(const uint8_t* registers)
+{
+    TimeFields fields;
+    TimeBlock::decode(registers, fields);
+
+    _second    = fields.second;
+    _minute    = fields.minute;
+    _hour      = fields.hour;
+    _dayOfWeek = fields.dayOfWeek;
+    _day       = fields.day;
+    _month     = fields.month;
+    _year      = fields.year;
 }
 
 /**
@@ -134,32 +319,18 @@ void RealTimeClock::readDateTime()
  * -# External influences upon the crystal (leakage, coupling, etc.).
  *
  * Every time we set a new date/time, it is necessary to clear this flag.
- */
-void RealTimeClock::clearOscillatorStopFlag() const
-{
-    uint8_t statusRegister = readRegister(RTC_ADDR_STATUS);
-    setBitOff(statusRegister, RTC_REG_STATUS_OSF);
-    writeRegister(RTC_ADDR_STATUS, statusRegister);
-}
-
-/**
- * Calculates the day of the week based.
- *
- * This is small and very efficient algorithm, created by Tomohiko Sakamoto, to calculate the day of the week, base on
- * a given date.
- *
- * You may find more details about how it works at: https://www.quora.com/How-does-Tomohiko-Sakamotos-Algorithm-work
  *
- * @param year  The year with century (format yyyy). Examples: 1995, 2007, etc.
- * @param month The month (from 1 to 12).
- * @param day   The day of month (from 1 to the number of days in month).
- * @return      The day of the week from (0 to 6).
+ * @return True if successful, or false if the I2C transfer failed.
  */
-uint8_t RealTimeClock::calculateDayOfWeek(int16_t year, uint8_t month, uint8_t day)
+bool RealTimeClock::clearOscillatorStopFlag() const
 {
-    static const uint8_t monthsArray[] PROGMEM = { 0, 3, 2, 5, 0, 3, 5, 1, 4, 6, 2, 4 };
-    year -= month < 3;
-    return (year + year / 4 - year / 100 + year / 400 + pgm_read_byte(monthsArray + (month - 1)) + day) % 7;
+    uint8_t statusRegister;
+    if (!readCachedRegister(RTC_ADDR_STATUS, statusRegister))
+    {
+        return false;
+    }
+    setBitOff(statusRegister, RTC_REG_STATUS_OSF);
+    return writeRegister(RTC_ADDR_STATUS, statusRegister);
 }
 
 /**
@@ -248,6 +419,18 @@ int16_t RealTimeClock::getYear() const
     return _year;
 }
 
+/**
+ * Gets the date/time represented by this instance as Unix time.
+ *
+ * \b Note: You must call readDateTime() before using this method, otherwise it will return an undefined value.
+ *
+ * @return The number of seconds since 1970-01-01 00:00:00.
+ */
+uint32_t RealTimeClock::getUnixTime() const
+{
+    return Calendar::toUnixTime(_year, _month, _day, _hour, _minute, _second);
+}
+
 /**
  * Forces the device to update the temperature.
  *
@@ -257,50 +440,138 @@ int16_t RealTimeClock::getYear() const
  * Since an update can only happen when a conversion is not already in progress, this method returns true if the
  * command is successful or false, otherwise.
  *
- * @return True if successful or false, otherwise.
+ * @return True if successful, or false if a conversion is in progress or the I2C transfer failed.
  */
 bool RealTimeClock::forceTemperatureUpdate() const
 {
-    uint8_t statusRegister = readRegister(RTC_ADDR_STATUS);
-    if (isBitSet(statusRegister, RTC_REG_STATUS_BSY))
+    uint8_t statusRegister;
+    if (!readRegister(RTC_ADDR_STATUS, statusRegister) || isBitSet(statusRegister, RTC_REG_STATUS_BSY))
+    {
+        return false;
+    }
+    uint8_t controlRegister;
+    if (!readCachedRegister(RTC_ADDR_CONTROL, controlRegister))
     {
         return false;
     }
-    uint8_t controlRegister = readRegister(RTC_ADDR_CONTROL);
     setBitOn(controlRegister, RTC_REG_CONTROL_CONV);
-    writeRegister(RTC_ADDR_CONTROL, controlRegister);
-    return true;
+    return writeRegister(RTC_ADDR_CONTROL, controlRegister);
 }
 
 /**
- * Reads current temperature in degrees Celsius.
+ * Reads current temperature in quarters of a degree Celsius.
+ *
+ * This method reads the temperature from the temperature registers. Bear in mind that these registers are updated
+ * every 64-seconds or after forceTemperatureUpdate() is called. Therefore, if you try to call this method multiple
+ * times, within 64-seconds (without forcing temperature update), the result will be the same.
+ *
+ * The resolution of this device is 0.25ºC, so the result is exact (e.g., 101 is 25.25ºC). Use the functions of
+ * the Temperature namespace to convert, compare and format it without floating point.
+ *
+ * @return The temperature in quarters of a degree Celsius, or RTC_TEMPERATURE_INVALID if the I2C transfer failed.
+ */
+int16_t RealTimeClock::readTemperatureQuarterDegrees() const
+{
+    uint8_t registers[2];
+    if (!readRegisters(RTC_ADDR_TEMPERATURE, registers, 2))
+    {
+        return RTC_TEMPERATURE_INVALID;
+    }
+
+    return decodeTemperature(registers);
+}
+
+/**
+ * Reads the temperature, in quarters of a degree Celsius, from a snapshot of the registers.
  *
- * This method reads the temperature from the temperature registers in degrees Celsius. Bear in mind that these
- * registers are updated every 64-seconds or after forceTemperatureUpdate() is called. Therefore, if you try
- * to call this method multiple times, within 64-seconds (without forcing temperature update), the result will be
- * the same.
+ * This method works like readTemperatureQuarterDegrees(), but it decodes the temperature from a snapshot previously
+ * read by BaseClock::readSnapshot(). Therefore, it does not communicate with the device.
  *
- * The resolution of this device is 0.25ºC.
+ * @param snapshot The snapshot of the registers.
+ * @return         The temperature in quarters of a degree Celsius.
+ */
+int16_t RealTimeClock::readTemperatureQuarterDegrees(const RegisterSnapshot& snapshot) const
+{
+    return decodeTemperature(snapshot.getRegisters(RTC_ADDR_TEMPERATURE));
+}
+
+/**
+ * Reads current temperature in degrees Celsius.
+ *
+ * This method is a floating-point wrapper of readTemperatureQuarterDegrees(). Sketches that do not call it do not
+ * link the floating-point library.
  *
- * @return The temperature in degrees Celsius.
+ * @return The temperature in degrees Celsius, or NAN if the I2C transfer failed.
  */
 float RealTimeClock::readTemperature() const
 {
-    uint8_t decimalPart, resolution;
-    float temperature;
+    int16_t quarterDegrees = readTemperatureQuarterDegrees();
+    if (quarterDegrees == RTC_TEMPERATURE_INVALID)
+    {
+        return NAN;
+    }
+    return Temperature::toCelsius(quarterDegrees);
+}
+
+/**
+ * Reads the temperature, in degrees Celsius, from a snapshot of the registers.
+ *
+ * This method is a floating-point wrapper of readTemperatureQuarterDegrees(const RegisterSnapshot&).
+ *
+ * @param snapshot The snapshot of the registers.
+ * @return         The temperature in degrees Celsius.
+ */
+float RealTimeClock::readTemperature(const RegisterSnapshot& snapshot) const
+{
+    return Temperature::toCelsius(readTemperatureQuarterDegrees(snapshot));
+}
 
-    Wire.beginTransmission(RTC_ADDR_I2C);
-    Wire.write(RTC_ADDR_TEMPERATURE);
-    Wire.endTransmission();
+/**
+ * Starts reading the temperature from the device, without waiting for the I2C transfer.
+ *
+ * This method returns at once. Call the poll() of the device periodically (BaseClock::poll(), for the default
+ * device): when the transfer finishes, the callback is called from poll() with the temperature in quarters of a
+ * degree Celsius.
+ *
+ * Only one asynchronous read may be pending on each device (see Device::beginAsyncRead()).
+ *
+ * @param callback The function called when the read finishes.
+ * @param context  Argument passed to the callback.
+ * @return         True if the read was started, or false if another read is still pending.
+ */
+bool RealTimeClock::readTemperatureAsync(TemperatureCallback callback, void* context)
+{
+    if (getDevice().isReadPending())
+    {
+        return false;
+    }
 
-    Wire.requestFrom(RTC_ADDR_I2C, 2);
-    decimalPart = Wire.read();
-    resolution  = Wire.read();
-    resolution  = resolution >> 6; //get only the upper nibble
+    _temperatureCallback = callback;
+    _callbackContext     = context;
+    return beginAsyncRead(RTC_ADDR_TEMPERATURE, 2, onTemperatureRead, this);
+}
 
-    temperature = (decimalPart & 0x80)            //negative (two's complement)?
-                ? (decimalPart | ~((1 << 8) - 1)) //convert it to a signed int
-                : decimalPart;                    //positive number
+/**
+ * Completes an asynchronous temperature read.
+ *
+ * @param owner     The clock that started the read.
+ * @param registers The content of the temperature registers.
+ * @param success   True if the registers were read.
+ */
+void RealTimeClock::onTemperatureRead(BaseClock* owner, const uint8_t* registers, bool success)
+{
+    RealTimeClock* clock = static_cast<RealTimeClock*>(owner);
+    int16_t temperature = success ? decodeTemperature(registers) : RTC_TEMPERATURE_INVALID;
+    clock->_temperatureCallback(temperature, success, clock->_callbackContext);
+}
 
-    return temperature + (resolution * 0.25);
+/**
+ * Decodes the temperature registers.
+ *
+ * @param registers The content of the 2 (two) temperature registers, starting at RTC_ADDR_TEMPERATURE.
+ * @return          The temperature in quarters of a degree Celsius.
+ */
+int16_t RealTimeClock::decodeTemperature(const uint8_t* registers)
+{
+    return Temperature::fromRegisters(registers[0], registers[1]);
 }
@@ -17,9 +17,13 @@
 #define __AMPLIAR_DS3231_REALTIME_CLOCK_H__
 
 #include <stdint.h>
-#include <Wire.h>
 #include "BinaryHelper.h"
+#include "Calendar.h"
+#include "DateTime.h"
 #include "BaseClock.h"
+#include "RegisterSnapshot.h"
+#include "Temperature.h"
+#include "TimeBlock.h"
 
 namespace Ampliar { namespace DS3231 {
 
@@ -34,12 +38,36 @@ namespace Ampliar { namespace DS3231 {
 class RealTimeClock : public BaseClock
 {
 public:
-    void readDateTime();
+    /**
+     * Function called when an asynchronous date/time read finishes. The getters of the clock hold the new values.
+     */
+    typedef void (*DateTimeCallback)(const RealTimeClock& clock, bool success, void* context);
+
+    /**
+     * Function called when an asynchronous temperature read finishes, with the temperature in quarters of a degree
+     * Celsius (RTC_TEMPERATURE_INVALID if the read failed).
+     */
+    typedef void (*TemperatureCallback)(int16_t quarterDegrees, bool success, void* context);
+
+public:
+    explicit RealTimeClock(Device& device = BaseClock::getDefaultDevice());
+    bool readDateTime();
+    void readDateTime(const RegisterSnapshot& snapshot);
+    DateTime readNow() const;
+    DateTime readNow(const RegisterSnapshot& snapshot) const;
+    bool readDateTimeAsync(DateTimeCallback callback, void* context);
     void writeDateTime(int16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second);
+    void writeDateTime(const DateTime& dateTime);
+    uint32_t readUnixTime();
+    void writeUnixTime(uint32_t time);
     bool wasItStopped() const;
     //
     bool forceTemperatureUpdate() const;
+    int16_t readTemperatureQuarterDegrees() const;
+    int16_t readTemperatureQuarterDegrees(const RegisterSnapshot& snapshot) const;
     float readTemperature() const;
+    float readTemperature(const RegisterSnapshot& snapshot) const;
+    bool readTemperatureAsync(TemperatureCallback callback, void* context);
     //
     uint8_t getSecond() const;
     uint8_t getMinute() const;
@@ -48,6 +76,7 @@ public:
     uint8_t getMonth() const;
     uint8_t getDayOfWeek() const;
     int16_t getYear() const;
+    uint32_t getUnixTime() const;
 
 private:
     uint8_t _second;
@@ -57,8 +86,15 @@ private:
     uint8_t _month;
     uint8_t _dayOfWeek;
     int16_t _year;
-    void clearOscillatorStopFlag() const;
-    static uint8_t calculateDayOfWeek(int16_t year, uint8_t month, uint8_t day);
+    DateTimeCallback _dateTimeCallback;
+    TemperatureCallback _temperatureCallback;
+    void* _callbackContext;
+    bool clearOscillatorStopFlag() const;
+    void decodeDateTime(const uint8_t* registers);
+    static DateTime toDateTime(const uint8_t* registers);
+    static int16_t decodeTemperature(const uint8_t* registers);
+    static void onDateTimeRead(BaseClock* owner, const uint8_t* registers, bool success);
+    static void onTemperatureRead(BaseClock* owner, const uint8_t* registers, bool success);
 };
 
 }} //end of namespace
@@ -18,6 +18,17 @@
 using namespace Ampliar::DS3231;
 using namespace Ampliar::BinaryHelper;
 
+/**
+ * Constructor.
+ *
+ * @param device The device to be controlled (the default device, if omitted).
+ */
+RealTimeClockController::RealTimeClockController(Device& device):
+    BaseClock(device)
+{
+    //
+}
+
 /**
  * Checks whether the battery is enabled or not.
  *
@@ -28,7 +39,21 @@ using namespace Ampliar::BinaryHelper;
  */
 bool RealTimeClockController::isBatteryEnabled() const
 {
-    return !isBitSet(readRegister(RTC_ADDR_CONTROL), RTC_REG_CONTROL_EOSC);
+    return !isBitSet(readCachedRegister(RTC_ADDR_CONTROL), RTC_REG_CONTROL_EOSC);
+}
+
+/**
+ * Checks whether the battery is enabled, from a snapshot of the registers.
+ *
+ * This method works like isBatteryEnabled(), but it decodes the flag from a snapshot previously read by
+ * BaseClock::readSnapshot(). Therefore, it does not communicate with the device.
+ *
+ * @param snapshot The snapshot of the registers.
+ * @return         True if it is enabled.
+ */
+bool RealTimeClockController::isBatteryEnabled(const RegisterSnapshot& snapshot) const
+{
+    return !isBitSet(snapshot.getRegister(RTC_ADDR_CONTROL), RTC_REG_CONTROL_EOSC);
 }
 
 /**
@@ -36,10 +61,12 @@ bool RealTimeClockController::isBatteryEnabled() const
  *
  * This methods enables the battery when DS3231 switches to the battery, i.e., when the main power supply
  * is turned off.
+ *
+ * @return True if successful, or false if the I2C transfer failed.
  */
-void RealTimeClockController::enableBattery() const
+bool RealTimeClockController::enableBattery() const
 {
-    toggleBattery(true);
+    return toggleBattery(true);
 }
 
 /**
@@ -50,10 +77,12 @@ void RealTimeClockController::enableBattery() const
  *
  * \b Note: If you disable the battery and the power supply is cut off, the oscillator (clock) will stop. Therefore,
  * next time you start using your board, you will need to set the date/time again.
+ *
+ * @return True if successful, or false if the I2C transfer failed.
  */
-void RealTimeClockController::disableBattery() const
+bool RealTimeClockController::disableBattery() const
 {
-    toggleBattery(false);
+    return toggleBattery(false);
 }
 
 /**
@@ -62,10 +91,15 @@ void RealTimeClockController::disableBattery() const
  * This method toggles the battery-backed mode by changing the EOSC bit of the control register.
  *
  * @param on True to enable; false to disable.
+ * @return   True if successful, or false if the I2C transfer failed.
  */
-void RealTimeClockController::toggleBattery(bool on) const
+bool RealTimeClockController::toggleBattery(bool on) const
 {
-    uint8_t controlRegister = readRegister(RTC_ADDR_CONTROL);
+    uint8_t controlRegister;
+    if (!readCachedRegister(RTC_ADDR_CONTROL, controlRegister))
+    {
+        return false;
+    }
     if (on)
     {
         setBitOff(controlRegister, RTC_REG_CONTROL_EOSC);
@@ -74,7 +108,7 @@ void RealTimeClockController::toggleBattery(bool on) const
     {
         setBitOn(controlRegister, RTC_REG_CONTROL_EOSC);
     }
-    writeRegister(RTC_ADDR_CONTROL, controlRegister);
+    return writeRegister(RTC_ADDR_CONTROL, controlRegister);
 }
 
 /**
@@ -86,27 +120,45 @@ void RealTimeClockController::toggleBattery(bool on) const
  */
 bool RealTimeClockController::is32khzOutputEnabled() const
 {
-    return isBitSet(readRegister(RTC_ADDR_STATUS), RTC_REG_STATUS_EN32KHZ);
+    return isBitSet(readCachedRegister(RTC_ADDR_STATUS), RTC_REG_STATUS_EN32KHZ);
+}
+
+/**
+ * Checks whether the 32 kHz output is enabled, from a snapshot of the registers.
+ *
+ * This method works like is32khzOutputEnabled(), but it decodes the flag from a snapshot previously read by
+ * BaseClock::readSnapshot(). Therefore, it does not communicate with the device.
+ *
+ * @param snapshot The snapshot of the registers.
+ * @return         True if it is enabled.
+ */
+bool RealTimeClockController::is32khzOutputEnabled(const RegisterSnapshot& snapshot) const
+{
+    return isBitSet(snapshot.getRegister(RTC_ADDR_STATUS), RTC_REG_STATUS_EN32KHZ);
 }
 
 /**
  * Enables the 32 KHz output.
  *
  * This method enables an output of a 32.768 kHz square-wave signal on the correspondent pin of DS3231.
+ *
+ * @return True if successful, or false if the I2C transfer failed.
  */
-void RealTimeClockController::enable32khzOutput() const
+bool RealTimeClockController::enable32khzOutput() const
 {
-    toggle32khzOutput(true);
+    return toggle32khzOutput(true);
 }
 
 /**
  * Disables the 32 KHz output.
  *
  * This methods disables the 32 kHz output and the correspondent pin goes to a high-impedance state.
+ *
+ * @return True if successful, or false if the I2C transfer failed.
  */
-void RealTimeClockController::disable32khzOutput() const
+bool RealTimeClockController::disable32khzOutput() const
 {
-    toggle32khzOutput(false);
+    return toggle32khzOutput(false);
 }
 
 /**
@@ -115,10 +167,15 @@ void RealTimeClockController::disable32khzOutput() const
  * This method toggles the 32 KHz output pin by changing the EN32kHz bit of the status register.
  *
  * @param on True to enable; false to disable.
+ * @return   True if successful, or false if the I2C transfer failed.
  */
-void RealTimeClockController::toggle32khzOutput(bool on) const
+bool RealTimeClockController::toggle32khzOutput(bool on) const
 {
-    uint8_t statusRegister = readRegister(RTC_ADDR_STATUS);
+    uint8_t statusRegister;
+    if (!readCachedRegister(RTC_ADDR_STATUS, statusRegister))
+    {
+        return false;
+    }
     if (on)
     {
         setBitOn(statusRegister, RTC_REG_STATUS_EN32KHZ);
@@ -126,9 +183,8 @@ void RealTimeClockController::toggle32khzOutput(bool on) const
     else
     {
         setBitOff(statusRegister, RTC_REG_STATUS_EN32KHZ);
-
     }
-    writeRegister(RTC_ADDR_STATUS, statusRegister);
+    return writeRegister(RTC_ADDR_STATUS, statusRegister);
 }
 
 /**
@@ -141,7 +197,21 @@ void RealTimeClockController::toggle32khzOutput(bool on) const
  */
 bool RealTimeClockController::isBatteryBackedSquareWaveEnabled() const
 {
-    return isBitSet(readRegister(RTC_ADDR_CONTROL), RTC_REG_CONTROL_BBSQW);
+    return isBitSet(readCachedRegister(RTC_ADDR_CONTROL), RTC_REG_CONTROL_BBSQW);
+}
+
+/**
+ * Checks whether the battery-backed square-wave output is enabled, from a snapshot of the registers.
+ *
+ * This method works like isBatteryBackedSquareWaveEnabled(), but it decodes the flag from a snapshot previously read by
+ * BaseClock::readSnapshot(). Therefore, it does not communicate with the device.
+ *
+ * @param snapshot The snapshot of the registers.
+ * @return         True if it is enabled.
+ */
+bool RealTimeClockController::isBatteryBackedSquareWaveEnabled(const RegisterSnapshot& snapshot) const
+{
+    return isBitSet(snapshot.getRegister(RTC_ADDR_CONTROL), RTC_REG_CONTROL_BBSQW);
 }
 
 /**
@@ -153,11 +223,11 @@ bool RealTimeClockController::isBatteryBackedSquareWaveEnabled() const
  * This method also enables the square-wave output pin.
  *
  * @param frequency The frequency of the square-wave.
+ * @return          True if successful, or false if the I2C transfer failed.
  */
-void RealTimeClockController::enableBatteryBackedSquareWave(Frequency frequency) const
+bool RealTimeClockController::enableBatteryBackedSquareWave(Frequency frequency) const
 {
-    toggleBatteryBackedSquareWave(true);
-    enableSquareWave(frequency);
+    return toggleBatteryBackedSquareWave(true) && enableSquareWave(frequency);
 }
 
 /**
@@ -167,10 +237,12 @@ void RealTimeClockController::enableBatteryBackedSquareWave(Frequency frequency)
  * off.
  *
  * \b Note: This method does \b NOT turn off the square-wave output pin.
+ *
+ * @return True if successful, or false if the I2C transfer failed.
  */
-void RealTimeClockController::disableBatteryBackedSquareWave() const
+bool RealTimeClockController::disableBatteryBackedSquareWave() const
 {
-    toggleBatteryBackedSquareWave(false);
+    return toggleBatteryBackedSquareWave(false);
 }
 
 /**
@@ -179,10 +251,15 @@ void RealTimeClockController::disableBatteryBackedSquareWave() const
  * This method toggles the battery-backed square-wave output by changing the BBSQW bit of the control register.
  *
  * @param on True to enable; false to disable.
+ * @return   True if successful, or false if the I2C transfer failed.
  */
-void RealTimeClockController::toggleBatteryBackedSquareWave(bool on) const
+bool RealTimeClockController::toggleBatteryBackedSquareWave(bool on) const
 {
-    uint8_t controlRegister = readRegister(RTC_ADDR_CONTROL);
+    uint8_t controlRegister;
+    if (!readCachedRegister(RTC_ADDR_CONTROL, controlRegister))
+    {
+        return false;
+    }
     if (on)
     {
         setBitOn(controlRegister, RTC_REG_CONTROL_BBSQW);
@@ -191,7 +268,7 @@ void RealTimeClockController::toggleBatteryBackedSquareWave(bool on) const
     {
         setBitOff(controlRegister, RTC_REG_CONTROL_BBSQW);
     }
-    writeRegister(RTC_ADDR_CONTROL, controlRegister);
+    return writeRegister(RTC_ADDR_CONTROL, controlRegister);
 }
 
 /**
@@ -203,7 +280,21 @@ void RealTimeClockController::toggleBatteryBackedSquareWave(bool on) const
  */
 bool RealTimeClockController::isSquareWaveEnabled() const
 {
-    return !isBitSet(readRegister(RTC_ADDR_CONTROL), RTC_REG_CONTROL_INTCN);
+    return !isBitSet(readCachedRegister(RTC_ADDR_CONTROL), RTC_REG_CONTROL_INTCN);
+}
+
+/**
+ * Checks whether the square-wave mode is enabled, from a snapshot of the registers.
+ *
+ * This method works like isSquareWaveEnabled(), but it decodes the flag from a snapshot previously read by
+ * BaseClock::readSnapshot(). Therefore, it does not communicate with the device.
+ *
+ * @param snapshot The snapshot of the registers.
+ * @return         True if it is enabled.
+ */
+bool RealTimeClockController::isSquareWaveEnabled(const RegisterSnapshot& snapshot) const
+{
+    return !isBitSet(snapshot.getRegister(RTC_ADDR_CONTROL), RTC_REG_CONTROL_INTCN);
 }
 
 /**
@@ -212,10 +303,11 @@ bool RealTimeClockController::isSquareWaveEnabled() const
  * This method enables an output of a square-wave signal, at a given frequency, in the correspondent pin.
  *
  * @param frequency The frequency  of the square-wave.
+ * @return          True if successful, or false if the I2C transfer failed.
  */
-void RealTimeClockController::enableSquareWave(Frequency frequency) const
+bool RealTimeClockController::enableSquareWave(Frequency frequency) const
 {
-    toggleSquareWave(true, frequency);
+    return toggleSquareWave(true, frequency);
 }
 
 /**
@@ -224,12 +316,13 @@ void RealTimeClockController::enableSquareWave(Frequency frequency) const
  * It disables the square-wave output signal.
  *
  * \b Note: This method disables the battery-backed square-wave mode.
+ *
+ * @return True if successful, or false if the I2C transfer failed.
  */
-void RealTimeClockController::disableSquareWave() const
+bool RealTimeClockController::disableSquareWave() const
 {
     //it will ignore the frequency when disabled
-    toggleSquareWave(false, FREQ_1HZ);
-    disableBatteryBackedSquareWave();
+    return toggleSquareWave(false, FREQ_1HZ) && disableBatteryBackedSquareWave();
 }
 
 /**
@@ -239,10 +332,15 @@ void RealTimeClockController::disableSquareWave() const
  *
  * @param on        True to enable; false to disable.
  * @param frequency The frequency of the square-wave. This parameter will be ignored if the parameter "on" is false.
+ * @return          True if successful, or false if the I2C transfer failed.
  */
-void RealTimeClockController::toggleSquareWave(bool on, Frequency frequency) const
+bool RealTimeClockController::toggleSquareWave(bool on, Frequency frequency) const
 {
-    uint8_t controlRegister = readRegister(RTC_ADDR_CONTROL);
+    uint8_t controlRegister;
+    if (!readCachedRegister(RTC_ADDR_CONTROL, controlRegister))
+    {
+        return false;
+    }
 
     if (on)
     {
@@ -274,7 +372,7 @@ void RealTimeClockController::toggleSquareWave(bool on, Frequency frequency) con
     {
         setBitOn(controlRegister, RTC_REG_CONTROL_INTCN);
     }
-    writeRegister(RTC_ADDR_CONTROL, controlRegister);
+    return writeRegister(RTC_ADDR_CONTROL, controlRegister);
 }
 
 /**
@@ -286,7 +384,32 @@ void RealTimeClockController::toggleSquareWave(bool on, Frequency frequency) con
  */
 RealTimeClockController::Frequency RealTimeClockController::getSquareWaveFrequency() const
 {
-    uint8_t controlRegister = readRegister(RTC_ADDR_CONTROL);
+    return decodeFrequency(readCachedRegister(RTC_ADDR_CONTROL));
+}
+
+/**
+ * Returns the frequency of the square-wave signal, from a snapshot of the registers.
+ *
+ * This method works like getSquareWaveFrequency(), but it decodes the frequency from a snapshot previously read by
+ * BaseClock::readSnapshot(). Therefore, it does not communicate with the device.
+ *
+ * @param snapshot The snapshot of the registers.
+ * @return         Frequency of the square-wave signal.
+ */
+RealTimeClockController::Frequency RealTimeClockController::getSquareWaveFrequency(const RegisterSnapshot& snapshot)
+    const
+{
+    return decodeFrequency(snapshot.getRegister(RTC_ADDR_CONTROL));
+}
+
+/**
+ * Decodes the frequency of the square-wave signal from the control register.
+ *
+ * @param controlRegister The content of the control register.
+ * @return                Frequency of the square-wave signal.
+ */
+RealTimeClockController::Frequency RealTimeClockController::decodeFrequency(uint8_t controlRegister)
+{
     bool rs1 = isBitSet(controlRegister, RTC_REG_CONTROL_RS1);
     bool rs2 = isBitSet(controlRegister, RTC_REG_CONTROL_RS2);
 
@@ -318,10 +441,13 @@ RealTimeClockController::Frequency RealTimeClockController::getSquareWaveFrequen
  * capacitance from the array, increasing the oscillator frequency. (source: DS3231 datasheet, Maxim Integrated, 2015)
  *
  * Please referrer to the manufacture's datasheet for more information.
+ *
+ * @param value The aging offset.
+ * @return      True if successful, or false if the I2C transfer failed.
  */
-void RealTimeClockController::writeCalibration(int8_t value) const
+bool RealTimeClockController::writeCalibration(int8_t value) const
 {
-    writeRegister(RTC_ADDR_AGING, value);
+    return writeRegister(RTC_ADDR_AGING, value);
 }
 
 /**
@@ -331,5 +457,37 @@ void RealTimeClockController::writeCalibration(int8_t value) const
  */
 int8_t RealTimeClockController::readCalibration() const
 {
-    return readRegister(RTC_ADDR_AGING);
+    return readCachedRegister(RTC_ADDR_AGING);
+}
+
+/**
+ * Reads the value in the aging offset register, reporting whether the read succeeded.
+ *
+ * Use this method, instead of readCalibration(), before writing a value derived from the current one.
+ *
+ * @param value The variable that receives the aging offset (unchanged if the read failed).
+ * @return      True if successful or false, otherwise.
+ */
+bool RealTimeClockController::readCalibration(int8_t& value) const
+{
+    uint8_t agingRegister;
+    if (!readCachedRegister(RTC_ADDR_AGING, agingRegister))
+    {
+        return false;
+    }
+    value = agingRegister;
+    return true;
+}
+
+/**
+ * Reads the value in the aging offset register, from a snapshot of the registers.
+ *
+ * @see RegisterSnapshot::getCalibration().
+ *
+ * @param snapshot The snapshot of the registers.
+ * @return         user-provided value used to add to or subtract from the codes in the capacitance array registers.
+ */
+int8_t RealTimeClockController::readCalibration(const RegisterSnapshot& snapshot) const
+{
+    return snapshot.getCalibration();
 }
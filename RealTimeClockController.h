@@ -19,6 +19,7 @@
 #include <stdint.h>
 #include "BaseClock.h"
 #include "BinaryHelper.h"
+#include "RegisterSnapshot.h"
 
 namespace Ampliar { namespace DS3231 {
 
@@ -44,31 +45,40 @@ public:
     };
 
 public:
-    void enableBattery() const;
-    void disableBattery() const;
+    explicit RealTimeClockController(Device& device = BaseClock::getDefaultDevice());
+    bool enableBattery() const;
+    bool disableBattery() const;
     bool isBatteryEnabled() const;
+    bool isBatteryEnabled(const RegisterSnapshot& snapshot) const;
     //
-    void enable32khzOutput() const;
-    void disable32khzOutput() const;
+    bool enable32khzOutput() const;
+    bool disable32khzOutput() const;
     bool is32khzOutputEnabled() const;
+    bool is32khzOutputEnabled(const RegisterSnapshot& snapshot) const;
     //
-    void enableSquareWave(Frequency frequency) const;
-    void disableSquareWave() const;
+    bool enableSquareWave(Frequency frequency) const;
+    bool disableSquareWave() const;
     bool isSquareWaveEnabled() const;
+    bool isSquareWaveEnabled(const RegisterSnapshot& snapshot) const;
     Frequency getSquareWaveFrequency() const;
+    Frequency getSquareWaveFrequency(const RegisterSnapshot& snapshot) const;
     //
-    void enableBatteryBackedSquareWave(Frequency frequency) const;
-    void disableBatteryBackedSquareWave() const;
+    bool enableBatteryBackedSquareWave(Frequency frequency) const;
+    bool disableBatteryBackedSquareWave() const;
     bool isBatteryBackedSquareWaveEnabled() const;
+    bool isBatteryBackedSquareWaveEnabled(const RegisterSnapshot& snapshot) const;
     //
-    void writeCalibration(int8_t value) const;
+    bool writeCalibration(int8_t value) const;
     int8_t readCalibration() const;
+    bool readCalibration(int8_t& value) const;
+    int8_t readCalibration(const RegisterSnapshot& snapshot) const;
 
 private:
-    void toggleBattery(bool on) const;
-    void toggle32khzOutput(bool on) const;
-    void toggleBatteryBackedSquareWave(bool on) const;
-    void toggleSquareWave(bool on, Frequency frequency) const;
+    bool toggleBattery(bool on) const;
+    bool toggle32khzOutput(bool on) const;
+    bool toggleBatteryBackedSquareWave(bool on) const;
+    bool toggleSquareWave(bool on, Frequency frequency) const;
+    static Frequency decodeFrequency(uint8_t controlRegister);
 };
 
 }} //end of namespace
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "RegisterSnapshot.h"
+
+using namespace Ampliar::DS3231;
+using Ampliar::BinaryHelper::isBitSet;
+
+/**
+ * Constructor.
+ *
+ * This constructor does not read any information from the device. All registers are initialized with zero. Use
+ * BaseClock::readSnapshot() to fill this object.
+ */
+RegisterSnapshot::RegisterSnapshot()
+{
+    for (uint8_t i = 0; i < RTC_SNAPSHOT_SIZE; i++)
+    {
+        _registers[i] = 0;
+    }
+}
+
+/**
+ * Gets the raw content of a register.
+ *
+ * Check the datasheet or the header BaseClock.h to get the registers available and their addresses.
+ *
+ * @param address The address of the register (from 0x00 to 0x12).
+ * @return        The content of the register, or zero if the address is out of range.
+ */
+uint8_t RegisterSnapshot::getRegister(uint8_t address) const
+{
+    return address < RTC_SNAPSHOT_SIZE ? _registers[address] : 0;
+}
+
+/**
+ * Gets a pointer to the raw content of the registers, starting at a given address.
+ *
+ * This method is used to decode blocks of registers, like the date/time or the alarms.
+ *
+ * @param address The address of the first register (from 0x00 to 0x12).
+ * @return        Pointer to the content of the register.
+ */
+const uint8_t* RegisterSnapshot::getRegisters(uint8_t address) const
+{
+    return _registers + address;
+}
+
+/**
+ * Checks whether the oscillator stop flag (OSF) was set when the snapshot was taken.
+ *
+ * @see RealTimeClock::wasItStopped().
+ *
+ * @return True if the clock was stopped.
+ */
+bool RegisterSnapshot::wasItStopped() const
+{
+    return isBitSet(_registers[RTC_ADDR_STATUS], RTC_REG_STATUS_OSF);
+}
+
+/**
+ * Checks whether a temperature conversion was in progress (BSY) when the snapshot was taken.
+ *
+ * @return True if the device was busy.
+ */
+bool RegisterSnapshot::isBusy() const
+{
+    return isBitSet(_registers[RTC_ADDR_STATUS], RTC_REG_STATUS_BSY);
+}
+
+/**
+ * Checks whether the first alarm flag (A1F) was set when the snapshot was taken.
+ *
+ * Unlike BaseAlarm::wasItTriggered(), this method does not clear the flag.
+ *
+ * @return True if the first alarm was triggered.
+ */
+bool RegisterSnapshot::isAlarm1Triggered() const
+{
+    return isBitSet(_registers[RTC_ADDR_STATUS], RTC_REG_STATUS_A1F);
+}
+
+/**
+ * Checks whether the second alarm flag (A2F) was set when the snapshot was taken.
+ *
+ * Unlike BaseAlarm::wasItTriggered(), this method does not clear the flag.
+ *
+ * @return True if the second alarm was triggered.
+ */
+bool RegisterSnapshot::isAlarm2Triggered() const
+{
+    return isBitSet(_registers[RTC_ADDR_STATUS], RTC_REG_STATUS_A2F);
+}
+
+/**
+ * Gets the value of the aging offset register.
+ *
+ * @see RealTimeClockController::readCalibration().
+ *
+ * @return The aging offset.
+ */
+int8_t RegisterSnapshot::getCalibration() const
+{
+    return (int8_t)_registers[RTC_ADDR_AGING];
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_REGISTER_SNAPSHOT_H__
+#define __AMPLIAR_DS3231_REGISTER_SNAPSHOT_H__
+
+#include <stdint.h>
+#include "BaseClock.h"
+#include "BinaryHelper.h"
+
+namespace Ampliar { namespace DS3231 {
+
+/**
+ * Copy of the whole DS3231 register file (from 0x00 to 0x12).
+ *
+ * An instance of this class is filled by BaseClock::readSnapshot() in a single I2C transaction. Afterwards, the date
+ * and time, both alarms, the control and status registers, the aging offset and the temperature can be decoded from it
+ * without any further communication with the device, and all of them refer to the same instant.
+ *
+ * @see RealTimeClock::readDateTime(const RegisterSnapshot&)
+ * @see RealTimeClock::readTemperature(const RegisterSnapshot&)
+ * @see Alarm1::readAlarm(const RegisterSnapshot&)
+ * @see Alarm2::readAlarm(const RegisterSnapshot&)
+ *
+ * @author Daniel Murari Boatto
+ */
+class RegisterSnapshot
+{
+    friend class BaseClock;
+    friend class Device;
+
+public:
+    RegisterSnapshot();
+    uint8_t getRegister(uint8_t address) const;
+    const uint8_t* getRegisters(uint8_t address) const;
+    bool wasItStopped() const;
+    bool isBusy() const;
+    bool isAlarm1Triggered() const;
+    bool isAlarm2Triggered() const;
+    int8_t getCalibration() const;
+
+private:
+    /**
+     * Raw content of the registers, indexed by their addresses.
+     */
+    uint8_t _registers[RTC_SNAPSHOT_SIZE];
+};
+
+}} //end of namespace
+#endif //__AMPLIAR_DS3231_REGISTER_SNAPSHOT_H__
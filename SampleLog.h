@@ -0,0 +1,111 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_SAMPLE_LOG_H__
+#define __AMPLIAR_DS3231_SAMPLE_LOG_H__
+
+#include <stdint.h>
+
+namespace Ampliar { namespace DS3231 {
+
+#define RTC_LOG_MAGIC0          0x44 ///< First byte of a block header ('D')
+#define RTC_LOG_MAGIC1          0x4C ///< Second byte of a block header ('L')
+#define RTC_LOG_VERSION         1    ///< Version of the format
+#define RTC_LOG_HEADER_SIZE     10   ///< Size of a block header, in bytes
+#define RTC_LOG_MAX_RECORD      7    ///< Maximum size of a record (5-byte varint and 2 bytes of temperature/flags)
+#define RTC_LOG_MAX_RECORDS     255  ///< Maximum number of records of a block
+#define RTC_LOG_MIN_TEMPERATURE -512 ///< Lowest temperature that can be logged, in quarters of a degree (-128.00ºC)
+#define RTC_LOG_MAX_TEMPERATURE 511  ///< Highest temperature that can be logged, in quarters of a degree (127.75ºC)
+
+#define RTC_LOG_FLAG_A1F     0x01 ///< Alarm 1 Flag was set
+#define RTC_LOG_FLAG_A2F     0x02 ///< Alarm 2 Flag was set
+#define RTC_LOG_FLAG_BSY     0x04 ///< A temperature conversion was in progress
+#define RTC_LOG_FLAG_EN32KHZ 0x08 ///< The 32kHz output was enabled
+#define RTC_LOG_FLAG_OSF     0x10 ///< Oscillator Stop Flag was set
+#define RTC_LOG_FLAG_MARK    0x20 ///< Free for the application (e.g., an event or a button press)
+
+/**
+ * A record of a sample log.
+ */
+struct LogRecord
+{
+    uint32_t unixTime;      ///< Number of seconds since 1970-01-01 00:00:00
+    int16_t quarterDegrees; ///< Temperature, in quarters of a degree Celsius
+    uint8_t flags;          ///< Flags (see RTC_LOG_FLAG_A1F, RTC_LOG_FLAG_OSF, etc.)
+};
+
+/**
+ * Compact binary format of logs of (time, temperature, flags) samples, written by LogWriter and read by LogReader.
+ *
+ * A log is a sequence of blocks, each one a header followed by up to RTC_LOG_MAX_RECORDS records:
+ *
+ * | Offset | Size | Content                                                         |
+ * |--------|------|-----------------------------------------------------------------|
+ * | 0      | 2    | RTC_LOG_MAGIC0, RTC_LOG_MAGIC1                                  |
+ * | 2      | 1    | RTC_LOG_VERSION                                                 |
+ * | 3      | 1    | Number of records                                               |
+ * | 4      | 2    | Size of the records, in bytes (little-endian)                   |
+ * | 6      | 4    | Epoch: Unix time of the first record (little-endian)            |
+ *
+ * Each record is the delta-of-delta of its time (the change of the interval from the previous record, zero for the
+ * first one of a block) as a zigzag varint, followed by a little-endian 16-bit word with the temperature in the lower
+ * 10 bits (two's complement quarters of a degree) and the flags in the upper 6 bits. Samples taken at a steady rate
+ * take 3 bytes each, against about 40 bytes as text.
+ *
+ * Every block starts from an absolute time, so a damaged block does not affect the others, and a reader can resume
+ * at the next header.
+ *
+ * @author Daniel Murari Boatto
+ */
+namespace SampleLog {
+
+    /**
+     * Converts the content of the status register to log flags.
+     *
+     * @param status The content of the status register (RTC_ADDR_STATUS).
+     * @return       The flags (RTC_LOG_FLAG_A1F, RTC_LOG_FLAG_A2F, RTC_LOG_FLAG_BSY, RTC_LOG_FLAG_EN32KHZ and
+     *               RTC_LOG_FLAG_OSF).
+     */
+    constexpr uint8_t flagsFromStatus(uint8_t status)
+    {
+        //Bits 0 to 3 are the same, OSF moves from bit 7 to bit 4
+        return (status & 0x0F) | ((status >> 3) & RTC_LOG_FLAG_OSF);
+    }
+
+    /**
+     * Maps a signed value to an unsigned one, so small magnitudes of both signs have short varints.
+     *
+     * @param value The value.
+     * @return      0, -1, 1, -2, 2, ... map to 0, 1, 2, 3, 4, ...
+     */
+    constexpr uint32_t zigzag(int32_t value)
+    {
+        return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+    }
+
+    /**
+     * Inverts zigzag().
+     *
+     * @param value The mapped value.
+     * @return      The signed value.
+     */
+    constexpr int32_t unzigzag(uint32_t value)
+    {
+        return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+    }
+}
+
+}} //end of namespace
+#endif //__AMPLIAR_DS3231_SAMPLE_LOG_H__
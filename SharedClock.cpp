@@ -0,0 +1,237 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "SharedClock.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <errno.h>
+#include "Device.h"
+#include "RealTimeClock.h"
+#include "RegisterSnapshot.h"
+
+using namespace Ampliar::DS3231;
+
+/**
+ * Constructor. The poller is started by start().
+ *
+ * @param device  The device read by the poller (the default device, if omitted). It must remain valid while this
+ *                object exists, and no other thread may use its bus while the poller runs.
+ * @param seqlock The seqlock where the samples are published (if null, this object uses its own).
+ */
+SharedClock::SharedClock(Device& device, TimeSeqlock* seqlock):
+    _device(device), _seqlock(seqlock ? seqlock : &_ownSeqlock), _thread(), _running(false), _readCount(0)
+{
+    //
+}
+
+/**
+ * Destructor. It stops the poller.
+ */
+SharedClock::~SharedClock()
+{
+    stop();
+}
+
+/**
+ * Starts the poller thread.
+ *
+ * The first sample is published after the first rollover of the seconds register, within about one second.
+ *
+ * @return True if the poller is running, or false if the thread could not be created.
+ */
+bool SharedClock::start()
+{
+    if (_running)
+    {
+        return true;
+    }
+
+    _running = true;
+    if (pthread_create(&_thread, 0, run, this) != 0)
+    {
+        _running = false;
+    }
+    return _running;
+}
+
+/**
+ * Stops the poller thread and waits for it (up to about one second). The last sample remains readable.
+ */
+void SharedClock::stop()
+{
+    if (!_running)
+    {
+        return;
+    }
+
+    _running = false;
+    pthread_join(_thread, 0);
+}
+
+/**
+ * Checks whether the poller thread is running.
+ *
+ * @return True if it is running.
+ */
+bool SharedClock::isRunning() const
+{
+    return _running;
+}
+
+/**
+ * Gets the last sample published by the poller. This method never accesses the bus and never waits for the poller.
+ *
+ * @param sample The object that receives the sample.
+ * @return       True if a sample was published, or false, otherwise.
+ */
+bool SharedClock::read(TimeSample& sample) const
+{
+    return _seqlock->read(sample);
+}
+
+/**
+ * Gets the current time, extrapolated from the last sample with CLOCK_MONOTONIC.
+ *
+ * @param seconds The variable that receives the number of seconds since 1970-01-01 00:00:00.
+ * @param micros  The variable that receives the fraction of the second, in microseconds.
+ * @return        True if a sample was published, or false, otherwise.
+ */
+bool SharedClock::now(uint32_t& seconds, uint32_t& micros) const
+{
+    return _seqlock->now(seconds, micros);
+}
+
+/**
+ * Gets the number of reads done by the poller, which is the whole bus traffic of this object.
+ *
+ * @return The number of reads since the object was created.
+ */
+uint32_t SharedClock::getReadCount() const
+{
+    return _readCount;
+}
+
+/**
+ * Gets the seqlock where the samples are published.
+ *
+ * @return The seqlock.
+ */
+TimeSeqlock& SharedClock::getSeqlock() const
+{
+    return *_seqlock;
+}
+
+/**
+ * Body of the poller thread.
+ */
+void SharedClock::poll()
+{
+    RealTimeClock clock(_device);
+    RegisterSnapshot snapshot;
+    TimeSample sample     = TimeSample();
+    uint32_t lastTime     = 0;
+    uint64_t rollover     = 0; //expected time of the last rollover (zero while the phase is unknown)
+    uint64_t wakeup       = 0;
+    uint64_t advanceTime  = TimeSeqlock::monotonicMicros(); //time of the last read with a new second
+    uint32_t probeMicros  = RTC_SHARED_PROBE_MICROS;
+    bool probing          = true;
+    bool stalled          = false;
+    bool published        = false;
+
+    while (_running)
+    {
+        sleepUntil(wakeup);
+        uint64_t readTime = TimeSeqlock::monotonicMicros();
+        bool success      = _device.readSnapshot(snapshot);
+        if (success)
+        {
+            _readCount++;
+            clock.readDateTime(snapshot);
+        }
+
+        uint32_t time = clock.getUnixTime();
+        if (!success || lastTime == 0 || time == lastTime)
+        {
+            //Not incremented yet: the rollover is later than expected. If the device fails, or a second passes without
+            //a new one, the reads back off
+            lastTime = time;
+            probing  = true;
+            wakeup   = readTime + probeMicros;
+            if (!success || readTime - advanceTime > 1000000 + RTC_SHARED_MARGIN_MICROS)
+            {
+                stalled     = true;
+                probeMicros = (probeMicros * 2 < RTC_SHARED_BACKOFF_MICROS) ? probeMicros * 2
+                                                                            : RTC_SHARED_BACKOFF_MICROS;
+            }
+            if (published && !sample.stale && readTime - advanceTime > RTC_SHARED_STALE_MICROS)
+            {
+                sample.stale = true;
+                _seqlock->publish(sample);
+            }
+            continue;
+        }
+
+        //Probing finds the rollover within one probe interval, otherwise it is assumed on time (slightly earlier)
+        bool jumped = stalled || (!probing && time != lastTime + 1);
+        rollover    = (probing || jumped) ? readTime : rollover + 1000000 - RTC_SHARED_BIAS_MICROS;
+        probing     = false;
+        stalled     = false;
+        probeMicros = RTC_SHARED_PROBE_MICROS;
+        lastTime    = time;
+        advanceTime = readTime;
+
+        sample.unixTime       = time;
+        sample.rolloverMicros = rollover;
+        sample.quarterDegrees = clock.readTemperatureQuarterDegrees(snapshot);
+        sample.status         = snapshot.getRegister(RTC_ADDR_STATUS);
+        sample.stale          = false;
+        _seqlock->publish(sample);
+        published = true;
+
+        //After the time was set or the device stalled, the phase is unknown again: probe for the next rollover
+        wakeup = jumped ? readTime + RTC_SHARED_PROBE_MICROS : rollover + 1000000 + RTC_SHARED_MARGIN_MICROS;
+    }
+}
+
+/**
+ * Entry point of the poller thread.
+ *
+ * @param clock The shared clock.
+ * @return      Null.
+ */
+void* SharedClock::run(void* clock)
+{
+    static_cast<SharedClock*>(clock)->poll();
+    return 0;
+}
+
+/**
+ * Sleeps until a given time of CLOCK_MONOTONIC.
+ *
+ * @param micros The time, in microseconds (it returns at once if it is in the past).
+ */
+void SharedClock::sleepUntil(uint64_t micros)
+{
+    struct timespec deadline;
+    deadline.tv_sec  = micros / 1000000;
+    deadline.tv_nsec = (micros % 1000000) * 1000;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, 0) == EINTR)
+    {
+        //
+    }
+}
+
+#endif //__linux__
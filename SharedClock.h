@@ -0,0 +1,113 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_SHARED_CLOCK_H__
+#define __AMPLIAR_DS3231_SHARED_CLOCK_H__
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <stdint.h>
+#include <pthread.h>
+#include <atomic>
+#include "BaseClock.h"
+#include "TimeSeqlock.h"
+
+namespace Ampliar { namespace DS3231 {
+
+#define RTC_SHARED_MARGIN_MICROS  2000    ///< Delay between the expected rollover of the seconds and the read, in us
+#define RTC_SHARED_PROBE_MICROS   1000    ///< Interval between reads while waiting for a rollover, in microseconds
+#define RTC_SHARED_BIAS_MICROS    100     ///< Amount the expected rollover moves earlier every second, in microseconds
+#define RTC_SHARED_BACKOFF_MICROS 1000000 ///< Maximum interval between reads while the device fails or stalls, in us
+#define RTC_SHARED_STALE_MICROS   2000000 ///< Time without a new second before the sample is flagged as stale, in us
+
+/**
+ * Thread-safe front end of DS3231 for many readers in the same process.
+ *
+ * A poller thread reads the device once per second, just after the seconds register is incremented, and publishes the
+ * date/time, the temperature and the status flags through a TimeSeqlock. Readers call read() or now(), which never
+ * access the bus and never wait for the poller, so any number of threads share a single bus read per second.
+ *
+ * The poller keeps its phase with CLOCK_MONOTONIC: it sleeps until RTC_SHARED_MARGIN_MICROS after the expected
+ * rollover and reads the whole register file in one transaction. If the seconds were not incremented yet, it reads
+ * again every RTC_SHARED_PROBE_MICROS and takes the first read with the new second as the rollover. Since this only
+ * corrects a late rollover, the expected rollover moves RTC_SHARED_BIAS_MICROS earlier every second, so a host clock
+ * running slow relative to DS3231 is caught as well, at the cost of an extra read every
+ * RTC_SHARED_MARGIN_MICROS / RTC_SHARED_BIAS_MICROS seconds.
+ *
+ * If a read fails, or the seconds do not advance for more than a second (e.g., the oscillator is stopped), the interval
+ * between reads doubles up to RTC_SHARED_BACKOFF_MICROS, so a faulty device does not flood the bus. After
+ * RTC_SHARED_STALE_MICROS without a new second, the last sample is published again with TimeSample::stale set, so
+ * readers can tell that now() is only extrapolated by the host.
+ *
+ * The samples can also be published into a TimeSeqlock provided by the caller, e.g., in shared memory.
+ *
+ * @author Daniel Murari Boatto
+ */
+class SharedClock
+{
+public:
+    explicit SharedClock(Device& device = BaseClock::getDefaultDevice(), TimeSeqlock* seqlock = 0);
+    ~SharedClock();
+    bool start();
+    void stop();
+    bool isRunning() const;
+    //
+    bool read(TimeSample& sample) const;
+    bool now(uint32_t& seconds, uint32_t& micros) const;
+    uint32_t getReadCount() const;
+    TimeSeqlock& getSeqlock() const;
+
+private:
+    SharedClock(const SharedClock&);
+    SharedClock& operator=(const SharedClock&);
+    void poll();
+    static void* run(void* clock);
+    static void sleepUntil(uint64_t micros);
+
+    /**
+     * Device read by the poller.
+     */
+    Device& _device;
+
+    /**
+     * Seqlock owned by this object, used when none is provided.
+     */
+    TimeSeqlock _ownSeqlock;
+
+    /**
+     * Seqlock where the samples are published.
+     */
+    TimeSeqlock* _seqlock;
+
+    /**
+     * Thread of the poller.
+     */
+    pthread_t _thread;
+
+    /**
+     * True while the poller must keep running.
+     */
+    std::atomic<bool> _running;
+
+    /**
+     * Number of reads done by the poller.
+     */
+    std::atomic<uint32_t> _readCount;
+};
+
+}} //end of namespace
+
+#endif //__linux__
+#endif //__AMPLIAR_DS3231_SHARED_CLOCK_H__
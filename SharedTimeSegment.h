@@ -0,0 +1,236 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_SHARED_TIME_SEGMENT_H__
+#define __AMPLIAR_DS3231_SHARED_TIME_SEGMENT_H__
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <atomic>
+#include <new>
+#include "TimeSeqlock.h"
+
+#if ATOMIC_INT_LOCK_FREE != 2
+#error "The shared time segment requires lock-free 32-bit atomics"
+#endif
+
+namespace Ampliar { namespace DS3231 {
+
+#define RTC_SEGMENT_NAME           "/ds3231" ///< Default POSIX shared memory name of the segment
+#define RTC_SEGMENT_MAGIC          0x31333244UL ///< Identifies the segment ("D231" in memory)
+#define RTC_SEGMENT_VERSION        1 ///< Version of the layout of the segment
+#define RTC_SEGMENT_MAX_AGE_MICROS 3000000UL ///< Age of the last sample after which the publisher is considered gone
+
+/**
+ * Layout of the POSIX shared memory segment published by the rtcd daemon (see extras/rtcd).
+ *
+ * The segment holds a TimeSeqlock preceded by a header. Its layout is fixed: a client checks the magic number, the
+ * version and the size before using it, and a new layout must change RTC_SEGMENT_VERSION.
+ *
+ * @author Daniel Murari Boatto
+ */
+struct SharedTimeSegment
+{
+    std::atomic<uint32_t> magic; ///< RTC_SEGMENT_MAGIC once the segment is initialized (written last)
+    uint32_t version;            ///< RTC_SEGMENT_VERSION
+    uint32_t size;               ///< Size of the segment, in bytes
+    uint32_t reserved;           ///< Zero (keeps the seqlock aligned to 16 bytes)
+    TimeSeqlock seqlock;         ///< Samples published by the daemon
+
+    /**
+     * Checks whether the segment was initialized with the layout of this header.
+     *
+     * @return True if the magic number, the version and the size match.
+     */
+    bool isValid() const
+    {
+        return magic.load(std::memory_order_acquire) == RTC_SEGMENT_MAGIC && version == RTC_SEGMENT_VERSION
+               && size == sizeof(SharedTimeSegment);
+    }
+
+    /**
+     * Initializes the segment, unless it is already valid (e.g., the daemon was restarted while clients still map the
+     * segment, which then keep reading it). A valid segment is reused as is, even if the previous daemon died in the
+     * middle of a publication, since TimeSeqlock::publish() never writes the copy the readers use. Only the publisher
+     * may call this method.
+     *
+     * @param memory The mapped memory, at least sizeof(SharedTimeSegment) bytes, writable.
+     * @return       The segment.
+     */
+    static SharedTimeSegment* initialize(void* memory)
+    {
+        SharedTimeSegment* segment = static_cast<SharedTimeSegment*>(memory);
+        if (!segment->isValid())
+        {
+            segment->magic.store(0, std::memory_order_relaxed);
+            segment->version  = RTC_SEGMENT_VERSION;
+            segment->size     = sizeof(SharedTimeSegment);
+            segment->reserved = 0;
+            new (&segment->seqlock) TimeSeqlock();
+            segment->magic.store(RTC_SEGMENT_MAGIC, std::memory_order_release);
+        }
+        return segment;
+    }
+};
+
+/**
+ * Client of the time published by the rtcd daemon in shared memory.
+ *
+ * After open(), which maps the segment read-only, read() and now() are only a few loads from shared memory (now() also
+ * reads CLOCK_MONOTONIC, which Linux serves from the vDSO), with no system calls and no access to the bus. Any number
+ * of processes can be clients, while the daemon remains the only reader of the device.
+ *
+ * Example:
+ *
+ * SharedTimeClient client;
+ * uint32_t seconds, micros;
+ * if (client.open() && client.now(seconds, micros)) { ... }
+ *
+ * This class is header-only, so clients do not need to link the library.
+ *
+ * @author Daniel Murari Boatto
+ */
+class SharedTimeClient
+{
+public:
+    /**
+     * Creates a client. The segment is mapped by open().
+     */
+    SharedTimeClient():
+        _segment(0)
+    {
+        //
+    }
+
+    /**
+     * Destructor. It unmaps the segment.
+     */
+    ~SharedTimeClient()
+    {
+        close();
+    }
+
+    /**
+     * Maps the segment.
+     *
+     * @param name The POSIX shared memory name of the segment.
+     * @return     True if the segment was mapped, or false if it does not exist (the daemon did not create it yet) or
+     *             its layout does not match this header.
+     */
+    bool open(const char* name = RTC_SEGMENT_NAME)
+    {
+        close();
+        int fd = shm_open(name, O_RDONLY, 0);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat status;
+        void* memory = MAP_FAILED;
+        if (fstat(fd, &status) == 0 && (size_t)status.st_size >= sizeof(SharedTimeSegment))
+        {
+            memory = mmap(0, sizeof(SharedTimeSegment), PROT_READ, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+        if (memory == MAP_FAILED)
+        {
+            return false;
+        }
+
+        _segment = static_cast<const SharedTimeSegment*>(memory);
+        if (!_segment->isValid())
+        {
+            close();
+        }
+        return _segment != 0;
+    }
+
+    /**
+     * Unmaps the segment.
+     */
+    void close()
+    {
+        if (_segment)
+        {
+            munmap(const_cast<SharedTimeSegment*>(_segment), sizeof(SharedTimeSegment));
+            _segment = 0;
+        }
+    }
+
+    /**
+     * Checks whether the segment is mapped.
+     *
+     * @return True if it is mapped.
+     */
+    bool isOpen() const
+    {
+        return _segment != 0;
+    }
+
+    /**
+     * Gets the last sample published by the daemon.
+     *
+     * @param sample The object that receives the sample.
+     * @return       True if a sample was published, or false if none was or the segment is not mapped.
+     */
+    bool read(TimeSample& sample) const
+    {
+        return _segment && _segment->seqlock.read(sample);
+    }
+
+    /**
+     * Gets the current time, extrapolated from the last sample with CLOCK_MONOTONIC.
+     *
+     * @param seconds The variable that receives the number of seconds since 1970-01-01 00:00:00.
+     * @param micros  The variable that receives the fraction of the second, in microseconds.
+     * @return        True if a sample was published, or false if none was or the segment is not mapped.
+     */
+    bool now(uint32_t& seconds, uint32_t& micros) const
+    {
+        return _segment && _segment->seqlock.now(seconds, micros);
+    }
+
+    /**
+     * Checks whether the daemon is publishing, i.e., the last sample is younger than RTC_SEGMENT_MAX_AGE_MICROS. If
+     * the daemon stops, the segment remains readable, but the samples get old.
+     *
+     * @return True if the last sample is recent.
+     */
+    bool isAlive() const
+    {
+        TimeSample sample;
+        return read(sample) && TimeSeqlock::monotonicMicros() - sample.rolloverMicros < RTC_SEGMENT_MAX_AGE_MICROS;
+    }
+
+private:
+    SharedTimeClient(const SharedTimeClient&);
+    SharedTimeClient& operator=(const SharedTimeClient&);
+
+    /**
+     * Mapped segment (null if not mapped).
+     */
+    const SharedTimeSegment* _segment;
+};
+
+}} //end of namespace
+
+#endif //__linux__
+#endif //__AMPLIAR_DS3231_SHARED_TIME_SEGMENT_H__
@@ -0,0 +1,674 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Simulator.h"
+
+using namespace Ampliar::DS3231;
+using Ampliar::BinaryHelper::isBitSet;
+using Ampliar::BinaryHelper::bcdToDecimal;
+
+/**
+ * Increments a BCD value by one.
+ *
+ * @param value BCD value (the caller handles the overflow of the tens digit).
+ * @return      The value plus one, in BCD.
+ */
+static uint8_t incrementBcd(uint8_t value)
+{
+    return (value & 0x0F) == 0x09 ? (value + 0x07) : (value + 1);
+}
+
+/**
+ * Constructor.
+ *
+ * The simulated device starts in the same state of a real device right after the initial application of power,
+ * with a temperature of 25 degrees Celsius and no drift.
+ */
+Simulator::Simulator():
+    _pointer(0), _subsecondMicros(0), _conversionMicros(0), _secondsToConversion(RTC_SIM_CONVERSION_PERIOD),
+    _temperature(25 * 4), _drift(0), _driftRemainder(0), _elapsedSeconds(0), _tickCallback(0), _tickContext(0),
+    _transferLatency(0), _transferPolls(0), _transferState(TRANSFER_IDLE), _transferBuffer(0), _transferLength(0)
+{
+    powerOn();
+}
+
+/**
+ * Setups the simulated bus.
+ *
+ * Nothing needs to be done. This method exists to implement BusTransport.
+ */
+void Simulator::begin()
+{
+    //
+}
+
+/**
+ * Simulates the initial application of power.
+ *
+ * All registers go back to their power-on values: 01/01/1900 00:00:00 (Monday), alarms cleared, INTCN and the rate
+ * select bits set in the control register, and OSF and EN32kHz set in the status register. A temperature conversion
+ * is executed immediately.
+ */
+void Simulator::powerOn()
+{
+    for (uint8_t i = 0; i < RTC_SNAPSHOT_SIZE; i++)
+    {
+        _registers[i] = 0;
+    }
+    _registers[0x03]             = 0x01;
+    _registers[0x04]             = 0x01;
+    _registers[0x05]             = 0x01;
+    _registers[RTC_ADDR_CONTROL] = 0x1C;
+    _registers[RTC_ADDR_STATUS]  = 0x88;
+
+    _pointer             = 0;
+    _subsecondMicros     = 0;
+    _conversionMicros    = 0;
+    _secondsToConversion = RTC_SIM_CONVERSION_PERIOD;
+    _driftRemainder      = 0;
+    _elapsedSeconds      = 0;
+
+    finishConversion();
+}
+
+/**
+ * Writes bytes to the simulated device.
+ *
+ * The first byte sets the register pointer and the following ones are written in consecutive registers. Read-only
+ * bits (like BSY and the temperature registers) are preserved, and OSF, A1F and A2F can only be cleared.
+ *
+ * @param address The I2C address. Any address other than RTC_ADDR_I2C is not acknowledged.
+ * @param data    The bytes to be written.
+ * @param length  The number of bytes.
+ * @return        True if the address was acknowledged.
+ */
+bool Simulator::write(uint8_t address, const uint8_t* data, uint8_t length)
+{
+    if (address != RTC_ADDR_I2C)
+    {
+        return false;
+    }
+    if (length == 0)
+    {
+        return true;
+    }
+
+    _pointer = data[0] % RTC_SNAPSHOT_SIZE;
+    for (uint8_t i = 1; i < length; i++)
+    {
+        writeByte(data[i]);
+    }
+    return true;
+}
+
+/**
+ * Writes bytes to the simulated device and then reads from consecutive registers.
+ *
+ * @param address  The I2C address. Any address other than RTC_ADDR_I2C is not acknowledged.
+ * @param tx       The bytes to be written (usually the register address).
+ * @param txLength The number of bytes to be written.
+ * @param rx       The buffer that will receive the bytes read.
+ * @param rxLength The number of bytes to be read.
+ * @return         True if the address was acknowledged.
+ */
+bool Simulator::writeRead(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength)
+{
+    if (!write(address, tx, txLength))
+    {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < rxLength; i++)
+    {
+        rx[i] = readByte();
+    }
+    return true;
+}
+
+/**
+ * Starts an asynchronous write followed by a read.
+ *
+ * The bytes are written at once, but the registers are only read when the transfer finishes, in poll(). Therefore, an
+ * advance of the virtual clock while the transfer is pending is seen in the bytes read.
+ *
+ * @param address  The I2C address. Any address other than RTC_ADDR_I2C is not acknowledged.
+ * @param tx       The bytes to be written (usually the register address).
+ * @param txLength The number of bytes to be written.
+ * @param rx       The buffer that will receive the bytes read.
+ * @param rxLength The number of bytes to be read.
+ * @return         True if the transfer was started, or false if another one is still pending or its result was
+ *                 not collected by poll() yet.
+ */
+bool Simulator::beginWriteRead(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength)
+{
+    if (_transferState != TRANSFER_IDLE)
+    {
+        return false;
+    }
+
+    if (!write(address, tx, txLength))
+    {
+        _transferState = TRANSFER_FAILED;
+        return true;
+    }
+
+    _transferState  = TRANSFER_PENDING;
+    _transferPolls  = _transferLatency;
+    _transferBuffer = rx;
+    _transferLength = rxLength;
+    return true;
+}
+
+/**
+ * Checks the progress of the asynchronous transfer.
+ *
+ * @return The state of the transfer. TRANSFER_DONE or TRANSFER_FAILED is returned only once.
+ */
+BusTransport::TransferState Simulator::poll()
+{
+    if (_transferState == TRANSFER_PENDING)
+    {
+        if (_transferPolls > 0)
+        {
+            _transferPolls--;
+            return TRANSFER_PENDING;
+        }
+
+        for (uint8_t i = 0; i < _transferLength; i++)
+        {
+            _transferBuffer[i] = readByte();
+        }
+        _transferState = TRANSFER_DONE;
+    }
+
+    TransferState state = _transferState;
+    _transferState = TRANSFER_IDLE;
+    return state;
+}
+
+/**
+ * Advances the virtual clock.
+ *
+ * The oscillator runs faster or slower than the virtual clock according to the injected drift (see setDrift()) and
+ * the aging offset register. Alarms, temperature conversions and tick callbacks happen along the way.
+ *
+ * @param milliseconds The amount of virtual time, in milliseconds.
+ */
+void Simulator::advance(uint32_t milliseconds)
+{
+    int64_t micros = (int64_t)milliseconds * 1000;
+    int32_t error  = _drift - (int32_t)(int8_t)_registers[RTC_ADDR_AGING] * RTC_SIM_AGING_PPB;
+
+    //Keeps the fraction of microsecond, so small steps do not lose the drift
+    _driftRemainder += micros * error;
+    int64_t adjustment = _driftRemainder / 1000000000;
+    _driftRemainder -= adjustment * 1000000000;
+    micros += adjustment;
+
+    while (micros > 0)
+    {
+        uint32_t chunk = micros > 1000000000 ? 1000000000 : (uint32_t)micros;
+        step(chunk);
+        micros -= chunk;
+    }
+}
+
+/**
+ * Advances the virtual clock by whole seconds.
+ *
+ * @param seconds The amount of virtual time, in seconds.
+ */
+void Simulator::advanceSeconds(uint32_t seconds)
+{
+    while (seconds > 0)
+    {
+        uint32_t chunk = seconds > 1000000 ? 1000000 : seconds;
+        advance(chunk * 1000);
+        seconds -= chunk;
+    }
+}
+
+/**
+ * Gets the number of increments of the seconds register since power-on.
+ *
+ * @return The number of seconds counted by the simulated oscillator.
+ */
+uint32_t Simulator::getElapsedSeconds() const
+{
+    return _elapsedSeconds;
+}
+
+/**
+ * Sets the temperature measured by the next conversions.
+ *
+ * @param quarterDegrees The temperature, in 0.25 degrees Celsius (e.g., 100 for 25 degrees Celsius).
+ */
+void Simulator::setTemperature(int16_t quarterDegrees)
+{
+    _temperature = quarterDegrees;
+}
+
+/**
+ * Injects a frequency error in the oscillator.
+ *
+ * Positive values make the clock run fast. The aging offset register is applied on top of this value: each positive
+ * LSB slows the oscillator by RTC_SIM_AGING_PPB.
+ *
+ * @param partsPerBillion The frequency error, in parts per billion (1000 ppb = 1 ppm).
+ */
+void Simulator::setDrift(int32_t partsPerBillion)
+{
+    _drift = partsPerBillion;
+}
+
+/**
+ * Sets a function to be called every time the seconds register is incremented.
+ *
+ * This is the moment of the falling edge of the 1 Hz square-wave output.
+ *
+ * @param callback The function (null to disable).
+ * @param context  Argument passed to the function.
+ */
+void Simulator::setTickCallback(TickCallback callback, void* context)
+{
+    _tickCallback = callback;
+    _tickContext  = context;
+}
+
+/**
+ * Sets how long asynchronous transfers stay pending.
+ *
+ * @param polls The number of calls to poll() that return TRANSFER_PENDING before the transfer finishes. With 0 (the
+ *              default), the first call finishes the transfer.
+ */
+void Simulator::setTransferLatency(uint8_t polls)
+{
+    _transferLatency = polls;
+}
+
+/**
+ * Gets the content of a register without going through the bus.
+ *
+ * @param address The address of the register.
+ * @return        The content of the register.
+ */
+uint8_t Simulator::peekRegister(uint8_t address) const
+{
+    return _registers[address % RTC_SNAPSHOT_SIZE];
+}
+
+/**
+ * Sets the content of a register without going through the bus and without applying any rule.
+ *
+ * @param address The address of the register.
+ * @param value   The new content of the register.
+ */
+void Simulator::pokeRegister(uint8_t address, uint8_t value)
+{
+    _registers[address % RTC_SNAPSHOT_SIZE] = value;
+}
+
+/**
+ * Checks whether the INT/SQW pin is asserted (low) by an alarm.
+ *
+ * @return True if an enabled alarm flag is set and INTCN is set.
+ */
+bool Simulator::isInterruptActive() const
+{
+    uint8_t control = _registers[RTC_ADDR_CONTROL];
+    uint8_t status  = _registers[RTC_ADDR_STATUS];
+
+    if (!isBitSet(control, RTC_REG_CONTROL_INTCN))
+    {
+        return false;
+    }
+    return (isBitSet(status, RTC_REG_STATUS_A1F) && isBitSet(control, RTC_REG_CONTROL_A1IE))
+        || (isBitSet(status, RTC_REG_STATUS_A2F) && isBitSet(control, RTC_REG_CONTROL_A2IE));
+}
+
+/**
+ * Checks whether a temperature conversion is in progress.
+ *
+ * @return True if BSY is set.
+ */
+bool Simulator::isBusy() const
+{
+    return isBitSet(_registers[RTC_ADDR_STATUS], RTC_REG_STATUS_BSY);
+}
+
+/**
+ * Writes one byte at the register pointer and increments it.
+ *
+ * @param value The byte written by the bus master.
+ */
+void Simulator::writeByte(uint8_t value)
+{
+    uint8_t* registers = _registers;
+
+    switch (_pointer)
+    {
+        case 0x00:
+            registers[0x00] = value & 0x7F;
+            _subsecondMicros = 0; //the countdown chain is reset when the seconds are written
+            break;
+
+        case 0x01:
+            registers[0x01] = value & 0x7F;
+            break;
+
+        case 0x02:
+            registers[0x02] = value & 0x7F;
+            break;
+
+        case 0x03:
+            registers[0x03] = value & 0x07;
+            break;
+
+        case 0x04:
+            registers[0x04] = value & 0x3F;
+            break;
+
+        case 0x05:
+            registers[0x05] = value & 0x9F;
+            break;
+
+        case RTC_ADDR_CONTROL:
+            registers[RTC_ADDR_CONTROL] = value;
+            if (isBitSet(value, RTC_REG_CONTROL_CONV) && !isBusy())
+            {
+                startConversion();
+            }
+            break;
+
+        case RTC_ADDR_STATUS:
+        {
+            uint8_t status = registers[RTC_ADDR_STATUS];
+            registers[RTC_ADDR_STATUS] = (status & value & RTC_REG_STATUS_STICKY_MASK)
+                                       | (status & (1 << RTC_REG_STATUS_BSY))
+                                       | (value  & (1 << RTC_REG_STATUS_EN32KHZ));
+            break;
+        }
+
+        case RTC_ADDR_TEMPERATURE:
+        case RTC_ADDR_TEMPERATURE + 1:
+            break; //read-only
+
+        default:
+            registers[_pointer] = value;
+            break;
+    }
+
+    _pointer = (_pointer + 1) % RTC_SNAPSHOT_SIZE;
+}
+
+/**
+ * Reads one byte at the register pointer and increments it.
+ *
+ * @return The content of the register.
+ */
+uint8_t Simulator::readByte()
+{
+    uint8_t value = _registers[_pointer];
+    _pointer = (_pointer + 1) % RTC_SNAPSHOT_SIZE;
+    return value;
+}
+
+/**
+ * Runs the oscillator for a given amount of time.
+ *
+ * @param micros Oscillator time, in microseconds.
+ */
+void Simulator::step(uint32_t micros)
+{
+    while (micros > 0)
+    {
+        uint32_t chunk = 1000000 - _subsecondMicros;
+        if (_conversionMicros > 0 && _conversionMicros < chunk)
+        {
+            chunk = _conversionMicros;
+        }
+        if (micros < chunk)
+        {
+            chunk = micros;
+        }
+
+        micros           -= chunk;
+        _subsecondMicros += chunk;
+
+        if (_conversionMicros > 0)
+        {
+            _conversionMicros -= chunk;
+            if (_conversionMicros == 0)
+            {
+                finishConversion();
+            }
+        }
+
+        if (_subsecondMicros >= 1000000)
+        {
+            _subsecondMicros = 0;
+            tick();
+        }
+    }
+}
+
+/**
+ * Increments the seconds register and everything that depends on it.
+ */
+void Simulator::tick()
+{
+    incrementTime();
+    checkAlarms();
+    _elapsedSeconds++;
+
+    if (--_secondsToConversion == 0)
+    {
+        _secondsToConversion = RTC_SIM_CONVERSION_PERIOD;
+        if (!isBusy())
+        {
+            startConversion();
+        }
+    }
+
+    if (_tickCallback)
+    {
+        _tickCallback(_tickContext);
+    }
+}
+
+/**
+ * Increments the time and calendar registers by one second.
+ */
+void Simulator::incrementTime()
+{
+    uint8_t* registers = _registers;
+
+    //Seconds and minutes
+    for (uint8_t i = 0x00; i <= 0x01; i++)
+    {
+        if (registers[i] != 0x59)
+        {
+            registers[i] = incrementBcd(registers[i]);
+            return;
+        }
+        registers[i] = 0x00;
+    }
+
+    //Hours
+    bool newDay = false;
+    uint8_t hour = registers[0x02];
+    if (isBitSet(hour, 6)) //12-hour mode
+    {
+        uint8_t value = hour & 0x1F;
+        uint8_t pm    = hour & 0x20;
+        if (value == 0x11)
+        {
+            value  = 0x12;
+            pm    ^= 0x20;
+            newDay = (pm == 0);
+        }
+        else if (value == 0x12)
+        {
+            value = 0x01;
+        }
+        else
+        {
+            value = incrementBcd(value);
+        }
+        registers[0x02] = 0x40 | pm | value;
+    }
+    else
+    {
+        newDay = (hour == 0x23);
+        registers[0x02] = newDay ? 0x00 : incrementBcd(hour);
+    }
+
+    if (!newDay)
+    {
+        return;
+    }
+
+    //Day of the week
+    registers[0x03] = registers[0x03] >= 7 ? 1 : registers[0x03] + 1;
+
+    //Date
+    if (bcdToDecimal(registers[0x04]) < daysInMonth())
+    {
+        registers[0x04] = incrementBcd(registers[0x04]);
+        return;
+    }
+    registers[0x04] = 0x01;
+
+    //Month
+    uint8_t century = registers[0x05] & 0x80;
+    uint8_t month   = registers[0x05] & 0x1F;
+    if (month != 0x12)
+    {
+        registers[0x05] = century | incrementBcd(month);
+        return;
+    }
+    registers[0x05] = century | 0x01;
+
+    //Year and century
+    if (registers[0x06] != 0x99)
+    {
+        registers[0x06] = incrementBcd(registers[0x06]);
+        return;
+    }
+    registers[0x06]  = 0x00;
+    registers[0x05] ^= 0x80;
+}
+
+/**
+ * Checks both alarms against the current time and sets their flags.
+ *
+ * The second alarm has no seconds register, so it is only checked when the seconds are 00.
+ */
+void Simulator::checkAlarms()
+{
+    const uint8_t* registers = _registers;
+
+    if (matches(registers[RTC_ADDR_ALARM1],     registers[0x00], 0x7F)
+     && matches(registers[RTC_ADDR_ALARM1 + 1], registers[0x01], 0x7F)
+     && matches(registers[RTC_ADDR_ALARM1 + 2], registers[0x02], 0x7F)
+     && matchesDay(registers[RTC_ADDR_ALARM1 + 3]))
+    {
+        _registers[RTC_ADDR_STATUS] |= (1 << RTC_REG_STATUS_A1F);
+    }
+
+    if (registers[0x00] == 0x00
+     && matches(registers[RTC_ADDR_ALARM2],     registers[0x01], 0x7F)
+     && matches(registers[RTC_ADDR_ALARM2 + 1], registers[0x02], 0x7F)
+     && matchesDay(registers[RTC_ADDR_ALARM2 + 2]))
+    {
+        _registers[RTC_ADDR_STATUS] |= (1 << RTC_REG_STATUS_A2F);
+    }
+}
+
+/**
+ * Checks whether one alarm register matches the correspondent time register.
+ *
+ * @param alarmRegister The alarm register (bit 7 is the mask bit).
+ * @param timeRegister  The time register.
+ * @param mask          The bits compared.
+ * @return              True if the mask bit is set or if the values match.
+ */
+bool Simulator::matches(uint8_t alarmRegister, uint8_t timeRegister, uint8_t mask) const
+{
+    return isBitSet(alarmRegister, 7) || (alarmRegister & mask) == (timeRegister & mask);
+}
+
+/**
+ * Checks whether the day/date alarm register matches the current day of the week or date.
+ *
+ * @param alarmRegister The day/date alarm register (bit 7 is the mask bit and bit 6 is DY/DT).
+ * @return              True if the mask bit is set or if the values match.
+ */
+bool Simulator::matchesDay(uint8_t alarmRegister) const
+{
+    if (isBitSet(alarmRegister, 7))
+    {
+        return true;
+    }
+    if (isBitSet(alarmRegister, 6))
+    {
+        return (alarmRegister & 0x0F) == _registers[0x03];
+    }
+    return (alarmRegister & 0x3F) == _registers[0x04];
+}
+
+/**
+ * Starts a temperature conversion.
+ */
+void Simulator::startConversion()
+{
+    _registers[RTC_ADDR_STATUS] |= (1 << RTC_REG_STATUS_BSY);
+    _conversionMicros = RTC_SIM_CONVERSION_MICROS;
+}
+
+/**
+ * Finishes a temperature conversion.
+ *
+ * The temperature registers receive the value set by setTemperature() and both BSY and CONV are cleared.
+ */
+void Simulator::finishConversion()
+{
+    uint16_t value = (uint16_t)_temperature & 0x3FF;
+    _registers[RTC_ADDR_TEMPERATURE]     = (uint8_t)(value >> 2);
+    _registers[RTC_ADDR_TEMPERATURE + 1] = (uint8_t)((value & 0x03) << 6);
+    _registers[RTC_ADDR_STATUS]  &= ~(1 << RTC_REG_STATUS_BSY);
+    _registers[RTC_ADDR_CONTROL] &= ~(1 << RTC_REG_CONTROL_CONV);
+    _conversionMicros = 0;
+}
+
+/**
+ * Gets the number of days of the current month.
+ *
+ * Like the real device, every year divisible by 4 (including 00) is considered a leap year.
+ *
+ * @return The number of days (from 28 to 31).
+ */
+uint8_t Simulator::daysInMonth() const
+{
+    static const uint8_t days[] PROGMEM = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    uint8_t month = bcdToDecimal(_registers[0x05] & 0x1F);
+    uint8_t year  = bcdToDecimal(_registers[0x06]);
+
+    if (month == 2 && (year % 4) == 0)
+    {
+        return 29;
+    }
+    return pgm_read_byte(days + ((month - 1) % 12));
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_SIMULATOR_H__
+#define __AMPLIAR_DS3231_SIMULATOR_H__
+
+#include <stdint.h>
+#include "BaseClock.h"
+#include "BinaryHelper.h"
+#include "BusTransport.h"
+
+namespace Ampliar { namespace DS3231 {
+
+#define RTC_SIM_CONVERSION_PERIOD   64     ///< Seconds between automatic temperature conversions
+#define RTC_SIM_CONVERSION_MICROS   125000 ///< Duration of a temperature conversion (typical value), in microseconds
+#define RTC_SIM_AGING_PPB           100    ///< Frequency change caused by one LSB of the aging offset, in ppb
+
+/**
+ * Software model of a DS3231 attached to a simulated I2C bus.
+ *
+ * This class implements BusTransport, so it can be installed with BaseClock::setTransport() and used underneath
+ * RealTimeClock, Alarm1, Alarm2 and RealTimeClockController without changes. It models the register map described in
+ * BaseClock.h:
+ *
+ * - the register pointer, with auto-increment and wrap-around after the last register;
+ * - BCD time and calendar, with 12/24-hour modes, leap years and the century bit;
+ * - the mask bits (A1Mx, A2Mx and DY/DT) of both alarms and the flags A1F and A2F;
+ * - the flags OSF, BSY and EN32kHz, including the "write 0 to clear" rule of OSF, A1F and A2F;
+ * - automatic and CONV-triggered temperature conversions;
+ * - the aging offset, which changes the oscillator frequency along with an optional injected drift.
+ *
+ * Time only advances when advance() or advanceSeconds() is called, so the simulated device runs on a virtual clock
+ * controlled by the caller, as fast as the host allows.
+ *
+ * Asynchronous reads stay pending for a configurable number of calls to poll() (see setTransferLatency()), which
+ * imitates a transfer driven by interrupts.
+ *
+ * The main power supply is always assumed to be present, therefore EOSC does not stop the oscillator.
+ *
+ * @author Daniel Murari Boatto
+ */
+class Simulator : public BusTransport
+{
+public:
+    /**
+     * Function called every time the seconds register is incremented.
+     */
+    typedef void (*TickCallback)(void* context);
+
+public:
+    Simulator();
+    void begin();
+    bool write(uint8_t address, const uint8_t* data, uint8_t length);
+    bool writeRead(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength);
+    bool beginWriteRead(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength);
+    TransferState poll();
+    //
+    void powerOn();
+    void advance(uint32_t milliseconds);
+    void advanceSeconds(uint32_t seconds);
+    uint32_t getElapsedSeconds() const;
+    //
+    void setTemperature(int16_t quarterDegrees);
+    void setDrift(int32_t partsPerBillion);
+    void setTickCallback(TickCallback callback, void* context);
+    void setTransferLatency(uint8_t polls);
+    //
+    uint8_t peekRegister(uint8_t address) const;
+    void pokeRegister(uint8_t address, uint8_t value);
+    bool isInterruptActive() const;
+    bool isBusy() const;
+
+private:
+    void writeByte(uint8_t value);
+    uint8_t readByte();
+    void step(uint32_t micros);
+    void tick();
+    void incrementTime();
+    void checkAlarms();
+    bool matches(uint8_t alarmRegister, uint8_t timeRegister, uint8_t mask) const;
+    bool matchesDay(uint8_t alarmRegister) const;
+    void startConversion();
+    void finishConversion();
+    uint8_t daysInMonth() const;
+
+    /**
+     * Content of the registers, indexed by their addresses.
+     */
+    uint8_t _registers[RTC_SNAPSHOT_SIZE];
+
+    /**
+     * Register pointer.
+     */
+    uint8_t _pointer;
+
+    /**
+     * Microseconds elapsed since the last increment of the seconds register (oscillator time).
+     */
+    uint32_t _subsecondMicros;
+
+    /**
+     * Microseconds remaining until the end of the current temperature conversion (zero if idle).
+     */
+    uint32_t _conversionMicros;
+
+    /**
+     * Seconds remaining until the next automatic temperature conversion.
+     */
+    uint8_t _secondsToConversion;
+
+    /**
+     * Temperature that will be stored by the next conversion, in 0.25 degrees Celsius.
+     */
+    int16_t _temperature;
+
+    /**
+     * Injected frequency error, in parts per billion (positive values make the clock run fast).
+     */
+    int32_t _drift;
+
+    /**
+     * Accumulated frequency error, in microseconds multiplied by one billion.
+     */
+    int64_t _driftRemainder;
+
+    /**
+     * Number of increments of the seconds register since power-on.
+     */
+    uint32_t _elapsedSeconds;
+
+    /**
+     * Function called on every increment of the seconds register.
+     */
+    TickCallback _tickCallback;
+
+    /**
+     * Context passed to _tickCallback.
+     */
+    void* _tickContext;
+
+    /**
+     * Number of calls to poll() an asynchronous read stays pending.
+     */
+    uint8_t _transferLatency;
+
+    /**
+     * Remaining calls to poll() until the pending asynchronous read finishes.
+     */
+    uint8_t _transferPolls;
+
+    /**
+     * State of the asynchronous read.
+     */
+    TransferState _transferState;
+
+    /**
+     * Buffer of the pending asynchronous read.
+     */
+    uint8_t* _transferBuffer;
+
+    /**
+     * Number of bytes of the pending asynchronous read.
+     */
+    uint8_t _transferLength;
+};
+
+}} //end of namespace
+#endif //__AMPLIAR_DS3231_SIMULATOR_H__
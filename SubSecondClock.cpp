@@ -0,0 +1,154 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "SubSecondClock.h"
+
+using namespace Ampliar::DS3231;
+
+/**
+ * Creates a sub-second clock, which uses micros() as counter. Call begin() before using it.
+ *
+ * @param device The device of the clock (the default device, if omitted).
+ */
+SubSecondClock::SubSecondClock(Device& device):
+    TickedClock(device), _counter(readMicros), _counterFrequency(1000000), _lastEdgeCount(0), _previousEdgeCount(0),
+    _latchedEdges(0)
+{
+    //
+}
+
+/**
+ * Latches the counter and counts a falling edge of the square wave.
+ *
+ * This method is meant to be called from an interrupt handler, as early as possible, since every microsecond of
+ * latency is an error of the timestamps. It overrides TickedClock::tick(), so the counter is also latched when the
+ * handler calls it through a reference to TickedClock.
+ */
+void SubSecondClock::tick()
+{
+    uint32_t count = _counter();
+
+    _previousEdgeCount = _lastEdgeCount;
+    _lastEdgeCount     = count;
+    if (_latchedEdges < 2)
+    {
+        _latchedEdges = _latchedEdges + 1;
+    }
+    TickedClock::tick();
+}
+
+/**
+ * Gets the current date/time with sub-second resolution.
+ *
+ * This method does not access the bus. The seconds include the edges not yet applied by update().
+ *
+ * Before the first edge after begin(), the fraction of the second is unknown: it is reported as zero, with an error
+ * of one second. Before the second edge (or if the counter did not advance between the last two edges, e.g., it is
+ * stopped), the nominal frequency of the counter is used, with a tolerance of RTC_SUBSECOND_HOST_PPM.
+ *
+ * If edges stop arriving, the time is extrapolated with the last measured period and the error grows by
+ * RTC_SUBSECOND_HOST_PPM for each missing second.
+ *
+ * @return The timestamp and its estimated error.
+ */
+SubSecondTime SubSecondClock::getTime() const
+{
+    uint8_t edges;
+    uint8_t latchedEdges;
+    uint32_t lastEdgeCount;
+    uint32_t previousEdgeCount;
+    uint32_t count;
+
+    //The counters are written by tick() inside an interrupt: they are consistent if no edge arrived meanwhile
+    do
+    {
+        edges             = _edges;
+        latchedEdges      = _latchedEdges;
+        lastEdgeCount     = _lastEdgeCount;
+        previousEdgeCount = _previousEdgeCount;
+        count             = _counter();
+    }
+    while (edges != _edges);
+
+    SubSecondTime time;
+    time.seconds = _unixTime + (uint8_t)(edges - _appliedEdges);
+
+    if (latchedEdges == 0)
+    {
+        time.micros      = 0;
+        time.errorMicros = 1000000;
+        return time;
+    }
+
+    //One count of resolution at the edge and another one now
+    uint32_t resolution = (1000000 + _counterFrequency - 1) / _counterFrequency;
+    uint32_t period     = _counterFrequency;
+    uint32_t elapsed    = count - lastEdgeCount;
+    time.errorMicros    = RTC_SUBSECOND_LATENCY_MICROS + 2 * resolution;
+
+    if (latchedEdges >= 2 && lastEdgeCount != previousEdgeCount)
+    {
+        period = lastEdgeCount - previousEdgeCount;
+    }
+    else
+    {
+        time.errorMicros += (uint32_t)((uint64_t)elapsed * RTC_SUBSECOND_HOST_PPM / _counterFrequency);
+    }
+
+    if (elapsed >= period)
+    {
+        uint32_t missing  = elapsed / period;
+        time.seconds     += missing;
+        time.errorMicros += missing * RTC_SUBSECOND_HOST_PPM;
+        elapsed          %= period;
+    }
+
+    time.micros = (uint32_t)((uint64_t)elapsed * 1000000 / period);
+    return time;
+}
+
+/**
+ * Replaces the counter latched on every edge.
+ *
+ * \b Note: Call this method before begin() or while the interrupts of the square wave are disabled.
+ *
+ * @param counter   The function that returns the value of the counter.
+ * @param frequency The nominal frequency of the counter, in Hz (e.g., 32768 for a counter clocked by the 32 kHz
+ *                  output of DS3231). It must not be zero.
+ * @return          True if the counter was replaced, or false if the function is null or the frequency is zero (then,
+ *                  the current counter is kept).
+ */
+bool SubSecondClock::setCounter(CounterFunction counter, uint32_t frequency)
+{
+    if (!counter || frequency == 0)
+    {
+        return false;
+    }
+
+    _counter          = counter;
+    _counterFrequency = frequency;
+    _latchedEdges     = 0;
+    return true;
+}
+
+/**
+ * Reads the default counter.
+ *
+ * @return The value of micros().
+ */
+uint32_t SubSecondClock::readMicros()
+{
+    return getMicros();
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_SUB_SECOND_CLOCK_H__
+#define __AMPLIAR_DS3231_SUB_SECOND_CLOCK_H__
+
+#include <stdint.h>
+#include "Platform.h"
+#include "TickedClock.h"
+
+namespace Ampliar { namespace DS3231 {
+
+#define RTC_SUBSECOND_LATENCY_MICROS  10   ///< Assumed worst-case delay from an edge to its timestamp, in microseconds
+#define RTC_SUBSECOND_HOST_PPM        5000 ///< Assumed frequency tolerance of the host counter, in ppm (resonator)
+
+/**
+ * A timestamp with sub-second resolution.
+ */
+struct SubSecondTime
+{
+    uint32_t seconds;     ///< Number of seconds since 1970-01-01 00:00:00
+    uint32_t micros;      ///< Fraction of the second, in microseconds (from 0 to 999999)
+    uint32_t errorMicros; ///< Estimated maximum error of the timestamp, in microseconds
+};
+
+/**
+ * TickedClock with timestamps of sub-second resolution.
+ *
+ * On every falling edge of the 1 Hz square wave, tick() latches a free-running counter of the host (micros() by
+ * default). getTime() returns the seconds kept by TickedClock plus the fraction of the second elapsed since the last
+ * edge, measured with that counter.
+ *
+ * The fraction is scaled by the number of counts between the last two edges, which are exactly one second apart
+ * according to DS3231. Therefore, the frequency error of the host counter cancels out and the remaining error comes
+ * from the interrupt latency and the counter resolution (see SubSecondTime::errorMicros).
+ *
+ * The counter can be replaced with setCounter(). For instance, the 32 kHz output of DS3231 (see
+ * RealTimeClockController::enable32khzOutput()) can clock a hardware counter of the host, whose value is returned by
+ * the given function. Such a counter runs on the same oscillator as the square wave, so its scale never drifts.
+ *
+ * @author Daniel Murari Boatto
+ */
+class SubSecondClock : public TickedClock
+{
+public:
+    /**
+     * Function that returns the value of a free-running counter (it must wrap around at 2^32).
+     */
+    typedef uint32_t (*CounterFunction)();
+
+public:
+    explicit SubSecondClock(Device& device = BaseClock::getDefaultDevice());
+    void tick();
+    SubSecondTime getTime() const;
+    bool setCounter(CounterFunction counter, uint32_t frequency);
+
+private:
+    static uint32_t readMicros();
+
+    /**
+     * Function that returns the value of the counter.
+     */
+    CounterFunction _counter;
+
+    /**
+     * Nominal frequency of the counter, in Hz.
+     */
+    uint32_t _counterFrequency;
+
+    /**
+     * Value of the counter at the last edge.
+     */
+    volatile uint32_t _lastEdgeCount;
+
+    /**
+     * Value of the counter at the edge before the last one.
+     */
+    volatile uint32_t _previousEdgeCount;
+
+    /**
+     * Number of edges latched (saturated at 2).
+     */
+    volatile uint8_t _latchedEdges;
+};
+
+}} //end of namespace
+#endif //__AMPLIAR_DS3231_SUB_SECOND_CLOCK_H__
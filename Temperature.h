@@ -0,0 +1,157 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_TEMPERATURE_H__
+#define __AMPLIAR_DS3231_TEMPERATURE_H__
+
+#include <stdint.h>
+
+namespace Ampliar { namespace DS3231 {
+
+#define RTC_TEMPERATURE_FORMAT_LENGTH 8 ///< Size of the buffer required by Temperature::format() (e.g., "-198.40")
+#define RTC_TEMPERATURE_INVALID INT16_MIN ///< Temperature returned when the device could not be read
+
+/**
+ * Fixed-point temperature functions namespace.
+ *
+ * DS3231 measures the temperature in steps of 0.25ºC, so RealTimeClock::readTemperatureQuarterDegrees() returns it
+ * as an integer number of quarters of a degree Celsius (e.g., 101 is 25.25ºC). These functions convert, compare and
+ * format such values with integer arithmetic only, so sketches that do not call toCelsius() never link the
+ * floating-point library.
+ *
+ * Thresholds are converted once with fromCelsius() or fromFahrenheit(), which are constexpr, and then compared with
+ * the plain integer operators:
+ *
+ * ~~~~~~~~~~~~~~~{.cpp}
+ * if (clock.readTemperatureQuarterDegrees() > Temperature::fromCelsius(40)) { ... }
+ * ~~~~~~~~~~~~~~~
+ *
+ * @author Daniel Murari Boatto
+ */
+namespace Temperature {
+
+    /**
+     * Decodes the temperature registers of DS3231.
+     *
+     * @param msb The content of the upper temperature register (RTC_ADDR_TEMPERATURE).
+     * @param lsb The content of the lower temperature register (RTC_ADDR_TEMPERATURE + 1).
+     * @return    The temperature in quarters of a degree Celsius.
+     */
+    constexpr int16_t fromRegisters(uint8_t msb, uint8_t lsb)
+    {
+        //The integer part is two's complement and the upper 2 bits of the lower register are the quarters
+        return (int8_t)msb * 4 + (lsb >> 6);
+    }
+
+    /**
+     * Converts degrees Celsius to quarters of a degree Celsius.
+     *
+     * @param degrees The temperature in degrees Celsius (from -128 to 127).
+     * @return        The temperature in quarters of a degree Celsius.
+     */
+    constexpr int16_t fromCelsius(int16_t degrees)
+    {
+        return degrees * 4;
+    }
+
+    /**
+     * Converts degrees Fahrenheit to quarters of a degree Celsius, rounded toward zero.
+     *
+     * @param degrees The temperature in degrees Fahrenheit (from -198 to 261).
+     * @return        The temperature in quarters of a degree Celsius.
+     */
+    constexpr int16_t fromFahrenheit(int16_t degrees)
+    {
+        return (degrees - 32) * 20 / 9;
+    }
+
+    /**
+     * Converts quarters of a degree Celsius to hundredths of a degree Celsius (exact).
+     *
+     * @param quarterDegrees The temperature in quarters of a degree Celsius.
+     * @return               The temperature in hundredths of a degree Celsius (e.g., 2525 is 25.25ºC).
+     */
+    constexpr int16_t toCentiCelsius(int16_t quarterDegrees)
+    {
+        return quarterDegrees * 25;
+    }
+
+    /**
+     * Converts quarters of a degree Celsius to hundredths of a degree Fahrenheit (exact).
+     *
+     * @param quarterDegrees The temperature in quarters of a degree Celsius.
+     * @return               The temperature in hundredths of a degree Fahrenheit (e.g., 7745 is 77.45ºF).
+     */
+    constexpr int16_t toCentiFahrenheit(int16_t quarterDegrees)
+    {
+        return quarterDegrees * 45 + 3200;
+    }
+
+    /**
+     * Converts quarters of a degree Celsius to degrees Celsius, as floating point.
+     *
+     * This is the only function of this namespace that uses floating point.
+     *
+     * @param quarterDegrees The temperature in quarters of a degree Celsius.
+     * @return               The temperature in degrees Celsius.
+     */
+    inline float toCelsius(int16_t quarterDegrees)
+    {
+        return quarterDegrees * 0.25f;
+    }
+
+    /**
+     * Formats a temperature in hundredths of a degree (see toCentiCelsius() and toCentiFahrenheit()) as a decimal
+     * number with two decimal places (e.g., "-3.75").
+     *
+     * @param hundredths The temperature in hundredths of a degree.
+     * @param buffer     The buffer that receives the null-terminated text. It must have at least
+     *                   RTC_TEMPERATURE_FORMAT_LENGTH bytes.
+     * @return           The length of the text, not counting the null terminator.
+     */
+    inline uint8_t format(int16_t hundredths, char* buffer)
+    {
+        char digits[5];
+        uint8_t count  = 0;
+        uint8_t length = 0;
+        uint16_t value = (hundredths < 0) ? -(int32_t)hundredths : hundredths;
+
+        //Digits in reverse order, with at least one digit before the decimal point
+        do
+        {
+            digits[count++] = '0' + value % 10;
+            value /= 10;
+        }
+        while (value != 0 || count < 3);
+
+        if (hundredths < 0)
+        {
+            buffer[length++] = '-';
+        }
+        while (count > 2)
+        {
+            buffer[length++] = digits[--count];
+        }
+        buffer[length++] = '.';
+        buffer[length++] = digits[1];
+        buffer[length++] = digits[0];
+        buffer[length]   = '\0';
+
+        return length;
+    }
+}
+
+}} //end of namespace
+#endif //__AMPLIAR_DS3231_TEMPERATURE_H__
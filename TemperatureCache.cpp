@@ -0,0 +1,219 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "TemperatureCache.h"
+#include "BinaryHelper.h"
+
+using namespace Ampliar::DS3231;
+using namespace Ampliar::BinaryHelper;
+
+/**
+ * Creates an empty temperature cache. The first call of read() reads the registers.
+ *
+ * @param device The device of the sensor (the default device, if omitted).
+ */
+TemperatureCache::TemperatureCache(Device& device):
+    BaseClock(device),
+    _quarterDegrees(0), _readMillis(0), _requestMillis(0), _maxAge(RTC_TEMPERATURE_PERIOD_MILLIS), _valid(false),
+    _pending(false)
+{
+    //
+}
+
+/**
+ * Gets the temperature, in quarters of a degree Celsius.
+ *
+ * The registers are read only if the cached value is older than the maximum age (or there is no cached value). While
+ * a requested conversion is pending, this method checks it with isConversionDone() instead, and returns the value
+ * cached before the request until the conversion is seen finished.
+ *
+ * @return The temperature in quarters of a degree Celsius.
+ */
+int16_t TemperatureCache::read()
+{
+    if (_pending)
+    {
+        if (isConversionDone() || _valid)
+        {
+            return _quarterDegrees;
+        }
+    }
+    else if (_valid && getAge() < _maxAge)
+    {
+        return _quarterDegrees;
+    }
+
+    uint8_t registers[2];
+    if (readRegisters(RTC_ADDR_TEMPERATURE, registers, 2))
+    {
+        store(Temperature::fromRegisters(registers[0], registers[1]));
+    }
+    return _quarterDegrees;
+}
+
+/**
+ * Requests a new temperature conversion, without waiting for it.
+ *
+ * If a conversion is already in progress (BSY is set), it is not possible to force another one, but the one in
+ * progress updates the registers as well, so it is awaited instead. Requesting a conversion while another requested
+ * one is pending does nothing.
+ *
+ * The new value is available once isConversionDone() returns true.
+ *
+ * @return True if a conversion is pending, or false if the I2C transfer failed (then, nothing is requested).
+ */
+bool TemperatureCache::requestConversion()
+{
+    if (_pending)
+    {
+        return true;
+    }
+
+    uint8_t statusRegister;
+    if (!readRegister(RTC_ADDR_STATUS, statusRegister))
+    {
+        return false;
+    }
+    if (!isBitSet(statusRegister, RTC_REG_STATUS_BSY))
+    {
+        uint8_t controlRegister;
+        if (!readCachedRegister(RTC_ADDR_CONTROL, controlRegister))
+        {
+            return false;
+        }
+        setBitOn(controlRegister, RTC_REG_CONTROL_CONV);
+        if (!writeRegister(RTC_ADDR_CONTROL, controlRegister))
+        {
+            return false;
+        }
+    }
+    _requestMillis = getMillis();
+    _pending       = true;
+    return true;
+}
+
+/**
+ * Checks whether the requested conversion has finished, caching the new temperature if so.
+ *
+ * This method does not access the bus until RTC_TEMPERATURE_CONVERSION_MILLIS have elapsed since
+ * requestConversion(). After that, each call reads the control, status, aging and temperature registers in a single
+ * transaction: the conversion is finished when both CONV and BSY are clear, and the temperature read along with them
+ * is cached at once.
+ *
+ * @return True if the conversion has finished (or none was requested), or false, otherwise.
+ */
+bool TemperatureCache::isConversionDone()
+{
+    if (!_pending)
+    {
+        return true;
+    }
+    if (getMillis() - _requestMillis < RTC_TEMPERATURE_CONVERSION_MILLIS)
+    {
+        return false;
+    }
+
+    uint8_t registers[RTC_ADDR_TEMPERATURE + 2 - RTC_ADDR_CONTROL];
+    if (!readRegisters(RTC_ADDR_CONTROL, registers, sizeof(registers)))
+    {
+        return false;
+    }
+
+    uint8_t controlRegister = registers[0];
+    uint8_t statusRegister  = registers[RTC_ADDR_STATUS - RTC_ADDR_CONTROL];
+    if (isBitSet(controlRegister, RTC_REG_CONTROL_CONV) || isBitSet(statusRegister, RTC_REG_STATUS_BSY))
+    {
+        return false;
+    }
+
+    const uint8_t* temperature = registers + (RTC_ADDR_TEMPERATURE - RTC_ADDR_CONTROL);
+    store(Temperature::fromRegisters(temperature[0], temperature[1]));
+    _pending = false;
+    return true;
+}
+
+/**
+ * Checks whether a requested conversion is still pending. This method does not access the bus.
+ *
+ * @return True if a conversion was requested and not seen finished yet, or false, otherwise.
+ */
+bool TemperatureCache::isConversionPending() const
+{
+    return _pending;
+}
+
+/**
+ * Discards the cached temperature, so the next call of read() reads the registers.
+ */
+void TemperatureCache::expire()
+{
+    _valid = false;
+}
+
+/**
+ * Sets the maximum age of the cached temperature.
+ *
+ * The default value, RTC_TEMPERATURE_PERIOD_MILLIS, reads the registers at most once per automatic conversion. Since
+ * the automatic conversions are not synchronized with the reads, the value returned may then lag the registers by up
+ * to one period; a shorter maximum age reduces this lag at the cost of more reads.
+ *
+ * @param milliseconds The maximum age, in milliseconds (zero means the registers are always read).
+ */
+void TemperatureCache::setMaxAge(uint32_t milliseconds)
+{
+    _maxAge = milliseconds;
+}
+
+/**
+ * Gets the maximum age of the cached temperature.
+ *
+ * @return The maximum age, in milliseconds.
+ */
+uint32_t TemperatureCache::getMaxAge() const
+{
+    return _maxAge;
+}
+
+/**
+ * Gets the age of the cached temperature.
+ *
+ * @return The number of milliseconds since the temperature was read.
+ */
+uint32_t TemperatureCache::getAge() const
+{
+    return getMillis() - _readMillis;
+}
+
+/**
+ * Checks whether there is a cached temperature.
+ *
+ * @return True if the temperature was read and not expired, or false, otherwise.
+ */
+bool TemperatureCache::isValid() const
+{
+    return _valid;
+}
+
+/**
+ * Caches a temperature read from the registers.
+ *
+ * @param quarterDegrees The temperature in quarters of a degree Celsius.
+ */
+void TemperatureCache::store(int16_t quarterDegrees)
+{
+    _quarterDegrees = quarterDegrees;
+    _readMillis     = getMillis();
+    _valid          = true;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_TEMPERATURE_CACHE_H__
+#define __AMPLIAR_DS3231_TEMPERATURE_CACHE_H__
+
+#include <stdint.h>
+#include "Platform.h"
+#include "BaseClock.h"
+#include "Temperature.h"
+
+namespace Ampliar { namespace DS3231 {
+
+#define RTC_TEMPERATURE_PERIOD_MILLIS     64000UL ///< Period of the automatic temperature conversions, in milliseconds
+#define RTC_TEMPERATURE_CONVERSION_MILLIS 125     ///< Typical duration of a temperature conversion, in milliseconds
+
+/**
+ * Temperature reader that only accesses the bus when the temperature registers may have changed.
+ *
+ * DS3231 updates its temperature registers every 64 seconds, or when a conversion is forced with the CONV bit.
+ * Reading them more often only returns the same value again, so read() keeps the last value and reads the registers
+ * only when it is older than the maximum age (64 seconds by default, see setMaxAge()).
+ *
+ * Fresh values are requested with requestConversion(), which never waits for the BSY flag: if an automatic
+ * conversion is already in progress, its result is used instead. isConversionDone() does not access the bus before
+ * the typical conversion time has elapsed, and then reads the control, status and temperature registers in a single
+ * transaction, so the new value is cached as soon as the conversion is seen finished.
+ *
+ * Usage:
+ *
+ * ~~~~~~~~~~~~~~~{.cpp}
+ * cache.requestConversion();
+ * //...other work...
+ * if (cache.isConversionDone()) {
+ *     int16_t temperature = cache.read();
+ * }
+ * ~~~~~~~~~~~~~~~
+ *
+ * @author Daniel Murari Boatto
+ */
+class TemperatureCache : public BaseClock
+{
+public:
+    explicit TemperatureCache(Device& device = BaseClock::getDefaultDevice());
+    int16_t read();
+    bool requestConversion();
+    bool isConversionDone();
+    bool isConversionPending() const;
+    void expire();
+    //
+    void setMaxAge(uint32_t milliseconds);
+    uint32_t getMaxAge() const;
+    uint32_t getAge() const;
+    bool isValid() const;
+
+private:
+    void store(int16_t quarterDegrees);
+
+    /**
+     * Last temperature read, in quarters of a degree Celsius.
+     */
+    int16_t _quarterDegrees;
+
+    /**
+     * Value of millis() when the temperature was read.
+     */
+    uint32_t _readMillis;
+
+    /**
+     * Value of millis() when the pending conversion was requested.
+     */
+    uint32_t _requestMillis;
+
+    /**
+     * Number of milliseconds after which the cached temperature is read again.
+     */
+    uint32_t _maxAge;
+
+    /**
+     * True if the cached temperature was read at least once and not expired.
+     */
+    bool _valid;
+
+    /**
+     * True if a conversion was requested and not seen finished yet.
+     */
+    bool _pending;
+};
+
+}} //end of namespace
+#endif //__AMPLIAR_DS3231_TEMPERATURE_CACHE_H__
@@ -0,0 +1,343 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "TickedClock.h"
+
+using namespace Ampliar::DS3231;
+
+/**
+ * Creates a ticked clock. Call begin() before using it.
+ *
+ * @param device The device of the clock (the default device, if omitted).
+ */
+TickedClock::TickedClock(Device& device):
+    _clock(device), _edges(0), _appliedEdges(0), _unixTime(0), _secondsSinceResync(0), _edgeMillis(0), _windowMillis(0),
+    _windowSeconds(0), _windowStarted(false), _resyncCount(0), _resyncInterval(RTC_TICKED_RESYNC_INTERVAL),
+    _missedEdgeDetection(true),
+    _second(0), _minute(0), _hour(0), _day(0), _month(0), _dayOfWeek(0), _year(0)
+{
+    //
+}
+
+/**
+ * Virtual destructor.
+ *
+ * Currently, this method is empty.
+ */
+TickedClock::~TickedClock()
+{
+    //
+}
+
+/**
+ * Enables the 1 Hz square-wave output and reads the date/time from the device.
+ *
+ * \b Note: This method disables the alarm interrupts on the INT/SQW pin, since the pin outputs the square wave.
+ *
+ * @param resyncInterval The number of seconds between two resyncs over I2C (zero means only when an edge is missed).
+ */
+void TickedClock::begin(uint16_t resyncInterval)
+{
+    RealTimeClockController controller(_clock.getDevice());
+    controller.enableSquareWave(RealTimeClockController::FREQ_1HZ);
+
+    _resyncInterval = resyncInterval;
+    _resyncCount    = 0;
+    resync();
+}
+
+/**
+ * Counts a falling edge of the square wave.
+ *
+ * This method is meant to be called from an interrupt handler, so it only increments a counter and records the time
+ * of the edge. The copy of the date/time is advanced later, by update().
+ */
+void TickedClock::tick()
+{
+    _edgeMillis = getMillis();
+    _edges      = _edges + 1;
+}
+
+/**
+ * Applies the ticks received since the last call and resyncs over I2C when needed.
+ *
+ * Call this method on every iteration of loop(). It does not access the bus, unless a resync is due. At least one
+ * call every 255 seconds is required, otherwise ticks are lost (and detected as missed edges).
+ */
+void TickedClock::update()
+{
+    //The counter and the time of the last edge are written by tick() inside an interrupt: they are consistent if no
+    //edge arrived meanwhile
+    uint8_t edges;
+    uint32_t edgeMillis;
+    do
+    {
+        edges      = _edges;
+        edgeMillis = _edgeMillis;
+    }
+    while (edges != _edges);
+
+    uint8_t count = edges - _appliedEdges;
+    if (count > 0)
+    {
+        _appliedEdges        = edges;
+        _unixTime           += count;
+        _secondsSinceResync += count;
+        decodeUnixTime();
+    }
+
+    if (_resyncInterval > 0 && _secondsSinceResync >= _resyncInterval)
+    {
+        resync();
+        return;
+    }
+
+    if (_missedEdgeDetection && !checkEdges(count, edgeMillis))
+    {
+        resync();
+    }
+}
+
+/**
+ * Reads the date/time from the device, replacing the copy kept in RAM.
+ *
+ * If an edge arrives while the registers are read, it is not known whether the seconds register was read before or
+ * after the increment, so the registers are read again.
+ *
+ * @return True if successful, or false if the I2C transfer failed (the copy is left unchanged and the next call to
+ *         update() tries again).
+ */
+bool TickedClock::resync()
+{
+    uint8_t edges;
+    do
+    {
+        edges = _edges;
+        if (!_clock.readDateTime())
+        {
+            return false;
+        }
+    }
+    while (edges != _edges);
+
+    _appliedEdges       = edges;
+    _unixTime           = _clock.getUnixTime();
+    _secondsSinceResync = 0;
+    _windowMillis       = getMillis();
+    _windowSeconds      = 0;
+    _windowStarted      = false;
+    _resyncCount++;
+    decodeUnixTime();
+    return true;
+}
+
+/**
+ * Compares the ticks with the time elapsed according to millis(), to detect missed (or spurious) edges.
+ *
+ * The edges are timestamped by tick(), so the time between them does not depend on when update() is called. It is
+ * compared with the number of ticks over windows of up to RTC_TICKED_CHECK_WINDOW seconds, each one starting at an
+ * edge. Over such a window, the error of millis() (up to ~0.5% on boards with a ceramic resonator) is far below the
+ * second added or lost by a wrong edge, however long the resync interval is.
+ *
+ * @param count      The number of edges applied by this call to update().
+ * @param edgeMillis The value of millis() at the last edge.
+ * @return           True if the ticks agree with millis(), or false if a resync is needed.
+ */
+bool TickedClock::checkEdges(uint8_t count, uint32_t edgeMillis)
+{
+    if (count == 0)
+    {
+        //No edge since the start of the window (e.g., the square wave stopped)
+        uint32_t lastEdge = _windowStarted ? edgeMillis : _windowMillis;
+        return getMillis() - lastEdge <= RTC_TICKED_EDGE_TIMEOUT_MILLIS;
+    }
+
+    if (_windowStarted)
+    {
+        _windowSeconds += count;
+        int32_t error = (int32_t)(edgeMillis - _windowMillis - _windowSeconds * 1000UL);
+        if (error > RTC_TICKED_EDGE_TOLERANCE_MILLIS || error < -RTC_TICKED_EDGE_TOLERANCE_MILLIS)
+        {
+            return false;
+        }
+        if (_windowSeconds < RTC_TICKED_CHECK_WINDOW)
+        {
+            return true;
+        }
+    }
+
+    //The next window starts at this edge
+    _windowMillis  = edgeMillis;
+    _windowSeconds = 0;
+    _windowStarted = true;
+    return true;
+}
+
+/**
+ * Splits the Unix time kept in RAM into its date/time components.
+ */
+void TickedClock::decodeUnixTime()
+{
+    int32_t days                = Calendar::daysFromUnixTime(_unixTime);
+    Calendar::CivilDate date    = Calendar::civilFromDays(days);
+    uint32_t secondsOfDay       = Calendar::secondsOfDay(_unixTime);
+    uint16_t minutesOfDay       = secondsOfDay / 60;
+
+    _year      = date.year;
+    _month     = date.month;
+    _day       = date.day;
+    _dayOfWeek = Calendar::weekdayFromDays(days) + 1;
+    _hour      = minutesOfDay / 60;
+    _minute    = minutesOfDay % 60;
+    _second    = secondsOfDay % 60;
+}
+
+/**
+ * Sets the number of seconds between two resyncs over I2C.
+ *
+ * @param seconds The number of seconds (zero means only when an edge is missed).
+ */
+void TickedClock::setResyncInterval(uint16_t seconds)
+{
+    _resyncInterval = seconds;
+}
+
+/**
+ * Gets the number of seconds between two resyncs over I2C.
+ *
+ * @return The number of seconds (zero means only when an edge is missed).
+ */
+uint16_t TickedClock::getResyncInterval() const
+{
+    return _resyncInterval;
+}
+
+/**
+ * Enables the comparison of the ticks with millis(), which detects missed edges. It is enabled by default.
+ */
+void TickedClock::enableMissedEdgeDetection()
+{
+    _missedEdgeDetection = true;
+}
+
+/**
+ * Disables the comparison of the ticks with millis().
+ *
+ * Useful when the square wave does not follow the time base of millis(), e.g., when the device is simulated.
+ */
+void TickedClock::disableMissedEdgeDetection()
+{
+    _missedEdgeDetection = false;
+}
+
+/**
+ * Checks whether missed edges are detected.
+ *
+ * @return True if the ticks are compared with millis().
+ */
+bool TickedClock::isMissedEdgeDetectionEnabled() const
+{
+    return _missedEdgeDetection;
+}
+
+/**
+ * Gets the number of resyncs (reads of the date/time over I2C) since begin(), including the first one.
+ *
+ * @return The number of resyncs.
+ */
+uint32_t TickedClock::getResyncCount() const
+{
+    return _resyncCount;
+}
+
+/**
+ * Gets the seconds component of the date/time.
+ *
+ * @return The seconds component (from 0 to 59).
+ */
+uint8_t TickedClock::getSecond() const
+{
+    return _second;
+}
+
+/**
+ * Gets the minute component of the date/time.
+ *
+ * @return The minute component (from 0 to 59).
+ */
+uint8_t TickedClock::getMinute() const
+{
+    return _minute;
+}
+
+/**
+ * Gets the hour component of the date/time.
+ *
+ * @return The hour component (from 0 to 23).
+ */
+uint8_t TickedClock::getHour() const
+{
+    return _hour;
+}
+
+/**
+ * Gets the day of the month.
+ *
+ * @return The day of the month (from 1 to 31).
+ */
+uint8_t TickedClock::getDay() const
+{
+    return _day;
+}
+
+/**
+ * Gets the month component of the date/time.
+ *
+ * @return The month (from 1 to 12).
+ */
+uint8_t TickedClock::getMonth() const
+{
+    return _month;
+}
+
+/**
+ * Gets the day of the week, numbered like RealTimeClock::writeDateTime() stores it.
+ *
+ * @return The day of the week (from 1 to 7, where 1 is Sunday).
+ */
+uint8_t TickedClock::getDayOfWeek() const
+{
+    return _dayOfWeek;
+}
+
+/**
+ * Gets the year component of the date/time.
+ *
+ * @return The year in yyyy format.
+ */
+int16_t TickedClock::getYear() const
+{
+    return _year;
+}
+
+/**
+ * Gets the date/time as Unix time.
+ *
+ * @return The number of seconds since 1970-01-01 00:00:00.
+ */
+uint32_t TickedClock::getUnixTime() const
+{
+    return _unixTime;
+}
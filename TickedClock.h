@@ -0,0 +1,156 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_TICKED_CLOCK_H__
+#define __AMPLIAR_DS3231_TICKED_CLOCK_H__
+
+#include <stdint.h>
+#include "Platform.h"
+#include "Calendar.h"
+#include "RealTimeClock.h"
+#include "RealTimeClockController.h"
+
+namespace Ampliar { namespace DS3231 {
+
+#define RTC_TICKED_RESYNC_INTERVAL 3600 ///< Default number of seconds between two resyncs over I2C
+#define RTC_TICKED_CHECK_WINDOW          60   ///< Maximum number of seconds of ticks compared with millis() at a time
+#define RTC_TICKED_EDGE_TOLERANCE_MILLIS 500  ///< Difference between the ticks and millis() that triggers a resync
+#define RTC_TICKED_EDGE_TIMEOUT_MILLIS   2000 ///< Time without edges that triggers a resync
+
+/**
+ * Software copy of the DS3231 date/time, advanced by the 1 Hz square-wave output.
+ *
+ * The date/time is read over I2C once, by begin(). After that, every falling edge of the SQW pin, which is synchronous
+ * with the increment of the seconds register, advances a copy kept in RAM. Thus, the getters of this class cost no bus
+ * traffic at all.
+ *
+ * The square-wave output shares the INT/SQW pin with the alarm interrupts, so alarm interrupts cannot be used along
+ * with this class (the alarm flags can still be polled).
+ *
+ * Usage:
+ *
+ * - call begin() in setup(), which enables the 1 Hz square wave and reads the date/time;
+ * - call tick() on every falling edge of SQW, usually from an interrupt handler (see attachInterrupt());
+ * - call update() on every iteration of loop(), which applies the ticks and resyncs over I2C when needed.
+ *
+ * The copy is resynced over I2C every getResyncInterval() seconds and whenever the number of ticks disagrees with the
+ * time elapsed according to millis(), which happens when an edge is missed (or a spurious one is received). The edges
+ * are compared over short windows (see RTC_TICKED_CHECK_WINDOW), so the error of millis() never adds up to a second.
+ *
+ * @author Daniel Murari Boatto
+ */
+class TickedClock
+{
+public:
+    explicit TickedClock(Device& device = BaseClock::getDefaultDevice());
+    virtual ~TickedClock();
+    void begin(uint16_t resyncInterval = RTC_TICKED_RESYNC_INTERVAL);
+    virtual void tick();
+    void update();
+    bool resync();
+    //
+    void setResyncInterval(uint16_t seconds);
+    uint16_t getResyncInterval() const;
+    void enableMissedEdgeDetection();
+    void disableMissedEdgeDetection();
+    bool isMissedEdgeDetectionEnabled() const;
+    uint32_t getResyncCount() const;
+    //
+    uint8_t getSecond() const;
+    uint8_t getMinute() const;
+    uint8_t getHour() const;
+    uint8_t getDay() const;
+    uint8_t getMonth() const;
+    uint8_t getDayOfWeek() const;
+    int16_t getYear() const;
+    uint32_t getUnixTime() const;
+
+protected:
+    /**
+     * Clock used to read the date/time over I2C.
+     */
+    RealTimeClock _clock;
+
+    /**
+     * Number of falling edges received (written only by tick(), so it can be read without disabling interrupts).
+     */
+    volatile uint8_t _edges;
+
+    /**
+     * Value of _edges already applied to the copy of the date/time.
+     */
+    uint8_t _appliedEdges;
+
+    /**
+     * Copy of the date/time, as Unix time.
+     */
+    uint32_t _unixTime;
+
+    /**
+     * Number of seconds applied since the last resync.
+     */
+    uint32_t _secondsSinceResync;
+
+    /**
+     * Value of millis() at the last falling edge (written only by tick()).
+     */
+    volatile uint32_t _edgeMillis;
+
+    /**
+     * Value of millis() at the edge that started the window of the missed-edge detection (at the last resync, until
+     * the window is started).
+     */
+    uint32_t _windowMillis;
+
+    /**
+     * Number of seconds applied since the start of the window of the missed-edge detection.
+     */
+    uint16_t _windowSeconds;
+
+    /**
+     * True once an edge started the window of the missed-edge detection.
+     */
+    bool _windowStarted;
+
+    /**
+     * Number of resyncs since begin().
+     */
+    uint32_t _resyncCount;
+
+    /**
+     * Number of seconds between two resyncs (zero means never).
+     */
+    uint16_t _resyncInterval;
+
+    /**
+     * True if the ticks are checked against millis().
+     */
+    bool _missedEdgeDetection;
+
+private:
+    bool checkEdges(uint8_t count, uint32_t edgeMillis);
+    void decodeUnixTime();
+
+    uint8_t _second;
+    uint8_t _minute;
+    uint8_t _hour;
+    uint8_t _day;
+    uint8_t _month;
+    uint8_t _dayOfWeek;
+    int16_t _year;
+};
+
+}} //end of namespace
+#endif //__AMPLIAR_DS3231_TICKED_CLOCK_H__
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "TimeBlock.h"
+
+using namespace Ampliar::DS3231;
+
+#if defined(__AVR__)
+#define RTC_TIME_BLOCK_LOW_MASK  0x073F7F7FUL ///< Bits of the registers 0x00 to 0x03 holding BCD digits (24-hour mode)
+#define RTC_TIME_BLOCK_HIGH_MASK 0x00FF1F3FUL ///< Bits of the registers 0x04 to 0x06 holding BCD digits
+#define RTC_TIME_BLOCK_TENS      0x0F0F0F0FUL ///< Tens digit of each register, after shifting by 4 (four)
+#define RTC_TIME_BLOCK_12H       0x00200000UL ///< AM/PM bit of the hours register, in 12-hour mode
+
+/**
+ * Converts the BCD bytes of a word to decimal, all at once.
+ *
+ * @param bcd The BCD bytes (only the bits holding digits).
+ * @return    The decimal bytes.
+ */
+static inline uint32_t decimalFromBcd(uint32_t bcd)
+{
+    //decimal = bcd - 6 * tens
+    uint32_t tens = (bcd >> 4) & RTC_TIME_BLOCK_TENS;
+    return bcd - ((tens << 2) + (tens << 1));
+}
+#else
+#define RTC_TIME_BLOCK_MASK  0x00FF1F3F073F7F7FULL ///< Bits of each register holding BCD digits (24-hour mode)
+#define RTC_TIME_BLOCK_TENS  0x000F0F0F0F0F0F0FULL ///< Tens digit of each register, after shifting by 4 (four)
+#define RTC_TIME_BLOCK_12H   0x0000000000200000ULL ///< AM/PM bit of the hours register, in 12-hour mode
+#endif
+
+/**
+ * Decodes the 7 (seven) date/time registers.
+ *
+ * The registers are converted from BCD all at once, in a 64-bit word. On AVR, which has no 64-bit registers (the
+ * compiler would emulate every operation on a 64-bit word with 8 (eight) bytes), they are converted in two 32-bit
+ * words instead: the registers 0x00 to 0x03 and then 0x04 to 0x06.
+ *
+ * @param registers The content of the date/time registers, starting at RTC_ADDR_DATE.
+ * @param fields    The structure that will receive the decoded values.
+ */
+void TimeBlock::decode(const uint8_t* registers, TimeFields& fields)
+{
+    //In 12-hour mode (bit 6), bit 5 of the hours is AM/PM instead of the second tens digit
+    uint8_t hourRegister = registers[2];
+    bool twelveHour = (hourRegister & 0x40) != 0;
+
+#if defined(__AVR__)
+    uint32_t low  = registers[0] | (uint32_t)registers[1] << 8 | (uint32_t)registers[2] << 16
+                    | (uint32_t)registers[3] << 24;
+    uint32_t high = registers[4] | (uint32_t)registers[5] << 8 | (uint32_t)registers[6] << 16;
+    uint32_t mask = twelveHour ? (RTC_TIME_BLOCK_LOW_MASK & ~RTC_TIME_BLOCK_12H) : RTC_TIME_BLOCK_LOW_MASK;
+
+    uint32_t lowDecimal  = decimalFromBcd(low & mask);
+    uint32_t highDecimal = decimalFromBcd(high & RTC_TIME_BLOCK_HIGH_MASK);
+
+    fields.second    = (uint8_t)(lowDecimal);
+    fields.minute    = (uint8_t)(lowDecimal >> 8);
+    fields.hour      = (uint8_t)(lowDecimal >> 16);
+    fields.dayOfWeek = (uint8_t)(lowDecimal >> 24);
+    fields.day       = (uint8_t)(highDecimal);
+    fields.month     = (uint8_t)(highDecimal >> 8);
+    fields.year      = (uint8_t)(highDecimal >> 16);
+#else
+    uint64_t word = 0;
+    for (uint8_t i = 0; i < RTC_TIME_BLOCK_SIZE; i++)
+    {
+        word |= (uint64_t)registers[i] << (i * 8);
+    }
+    uint64_t mask = twelveHour ? (RTC_TIME_BLOCK_MASK & ~RTC_TIME_BLOCK_12H) : RTC_TIME_BLOCK_MASK;
+
+    //decimal = bcd - 6 * tens, for all bytes at once
+    uint64_t bcd  = word & mask;
+    uint64_t tens = (bcd >> 4) & RTC_TIME_BLOCK_TENS;
+    uint64_t decimal = bcd - ((tens << 2) + (tens << 1));
+
+    fields.second    = (uint8_t)(decimal);
+    fields.minute    = (uint8_t)(decimal >> 8);
+    fields.hour      = (uint8_t)(decimal >> 16);
+    fields.dayOfWeek = (uint8_t)(decimal >> 24);
+    fields.day       = (uint8_t)(decimal >> 32);
+    fields.month     = (uint8_t)(decimal >> 40);
+    fields.year      = (uint8_t)(decimal >> 48);
+#endif
+    fields.year     += (registers[5] & 0x80) != 0 ? 2000 : 1900;
+
+    if (twelveHour)
+    {
+        uint8_t hour = fields.hour == 12 ? 0 : fields.hour;
+        fields.hour  = (hourRegister & 0x20) != 0 ? hour + 12 : hour;
+    }
+}
+
+/**
+ * Decodes the 7 (seven) date/time registers as Unix time.
+ *
+ * @param registers The content of the date/time registers, starting at RTC_ADDR_DATE.
+ * @return          The number of seconds since 1970-01-01 00:00:00.
+ */
+uint32_t TimeBlock::toUnixTime(const uint8_t* registers)
+{
+    TimeFields fields;
+    decode(registers, fields);
+    return Calendar::toUnixTime(fields.year, fields.month, fields.day, fields.hour, fields.minute, fields.second);
+}
+
+/**
+ * Decodes consecutive 7-byte date/time records as Unix time.
+ *
+ * @param records The records, each one with the content of the date/time registers.
+ * @param count   The number of records.
+ * @param times   The array that will receive the number of seconds since 1970-01-01 00:00:00 of each record.
+ */
+void TimeBlock::toUnixTime(const uint8_t* records, size_t count, uint32_t* times)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        times[i] = toUnixTime(records + i * RTC_TIME_BLOCK_SIZE);
+    }
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_TIME_BLOCK_H__
+#define __AMPLIAR_DS3231_TIME_BLOCK_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Calendar.h"
+
+namespace Ampliar { namespace DS3231 {
+
+#define RTC_TIME_BLOCK_SIZE 7 ///< Number of date/time registers (from 0x00 to 0x06)
+
+/**
+ * Decoded content of the date/time registers.
+ */
+struct TimeFields
+{
+    uint8_t second;    ///< The seconds (from 0 to 59).
+    uint8_t minute;    ///< The minutes (from 0 to 59).
+    uint8_t hour;      ///< The hours in 24-hour format (from 0 to 23).
+    uint8_t dayOfWeek; ///< The day of the week (from 1 to 7).
+    uint8_t day;       ///< The day of the month (from 1 to 31).
+    uint8_t month;     ///< The month (from 1 to 12).
+    int16_t year;      ///< The year with century (format yyyy).
+};
+
+/**
+ * Decoder of the raw date/time registers.
+ *
+ * The 7 (seven) date/time registers are loaded into a single 64-bit word and all BCD digits are converted at once
+ * (SIMD within a register): since a BCD byte is 16 * tens + units, its decimal value is the byte minus 6 * tens, and
+ * this subtraction never borrows from the neighbour byte. The century bit and the 12/24-hour bits are masked before
+ * the conversion, and 12-hour values are converted to the 24-hour format.
+ *
+ * These functions can be used on the registers read by RealTimeClock::readDateTime() or on raw 7-byte records
+ * stored elsewhere (e.g., logs).
+ *
+ * @author Daniel Murari Boatto
+ */
+namespace TimeBlock {
+    void decode(const uint8_t* registers, TimeFields& fields);
+    uint32_t toUnixTime(const uint8_t* registers);
+    void toUnixTime(const uint8_t* records, size_t count, uint32_t* times);
+}
+
+}} //end of namespace
+#endif //__AMPLIAR_DS3231_TIME_BLOCK_H__
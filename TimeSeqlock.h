@@ -0,0 +1,201 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_TIME_SEQLOCK_H__
+#define __AMPLIAR_DS3231_TIME_SEQLOCK_H__
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <stdint.h>
+#include <time.h>
+#include <atomic>
+
+namespace Ampliar { namespace DS3231 {
+
+#define RTC_SAMPLE_WORDS 4 ///< Number of 32-bit words of a TimeSample in a TimeSeqlock
+
+/**
+ * A date/time read from DS3231, with the temperature and the status flags read in the same transaction.
+ */
+struct TimeSample
+{
+    uint32_t unixTime;       ///< Number of seconds since 1970-01-01 00:00:00
+    uint64_t rolloverMicros; ///< CLOCK_MONOTONIC time at which unixTime began, in microseconds (see monotonicMicros())
+    int16_t quarterDegrees;  ///< Temperature, in quarters of a degree Celsius
+    uint8_t status;          ///< Content of the status register (see RTC_REG_STATUS_OSF, RTC_REG_STATUS_BSY, etc.)
+    bool stale;              ///< True if no newer second could be read from the device for a while (see SharedClock)
+};
+
+/**
+ * Single-writer, multiple-reader publication of a TimeSample, protected by a sequence lock.
+ *
+ * The sample is kept in two copies (the "latch" variant of the seqlock): the writer always updates the copy the readers
+ * are not using, and then the sequence number directs the readers to it. Thus, readers never wait for the writer and
+ * never write anything themselves, so any number of them can read concurrently. A read is retried only if a
+ * publication finishes while the sample is copied. Since the copy the readers use is never written, a publication
+ * interrupted at any point (e.g., a publisher killed while the seqlock is in shared memory) leaves the previous sample
+ * intact.
+ *
+ * All fields are 32-bit atomics in a fixed layout, with no pointers, so an object of this class can also be placed in
+ * memory shared between processes.
+ *
+ * @author Daniel Murari Boatto
+ */
+class TimeSeqlock
+{
+public:
+    /**
+     * Creates an empty seqlock: read() returns false until the first publication.
+     */
+    TimeSeqlock():
+        _sequence(0)
+    {
+        for (uint8_t copy = 0; copy < 2; copy++)
+        {
+            for (uint8_t i = 0; i < RTC_SAMPLE_WORDS; i++)
+            {
+                _words[copy][i].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Publishes a sample. Only one thread (or process) may call this method.
+     *
+     * @param sample The sample.
+     */
+    void publish(const TimeSample& sample)
+    {
+        uint32_t words[RTC_SAMPLE_WORDS];
+        words[0] = sample.unixTime;
+        words[1] = (uint32_t)sample.rolloverMicros;
+        words[2] = (uint32_t)(sample.rolloverMicros >> 32);
+        words[3] = (uint16_t)sample.quarterDegrees | ((uint32_t)sample.status << 16) | (1UL << 24)
+                   | ((uint32_t)sample.stale << 25);
+
+        //The readers use the copy selected by the lowest bit of the sequence, so the other one is written and then
+        //released by the next sequence. The fence keeps the stores of this copy from being seen before the previous
+        //sequence, which released it to the readers of the previous publication
+        uint32_t sequence = _sequence.load(std::memory_order_relaxed) + 1;
+        std::atomic_thread_fence(std::memory_order_release);
+        store(sequence & 1, words);
+        _sequence.store(sequence, std::memory_order_release);
+    }
+
+    /**
+     * Reads the last sample published.
+     *
+     * @param sample The object that receives the sample.
+     * @return       True if a sample was published, or false, otherwise.
+     */
+    bool read(TimeSample& sample) const
+    {
+        uint32_t words[RTC_SAMPLE_WORDS];
+        uint32_t sequence;
+        do
+        {
+            sequence = _sequence.load(std::memory_order_acquire);
+            for (uint8_t i = 0; i < RTC_SAMPLE_WORDS; i++)
+            {
+                words[i] = _words[sequence & 1][i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        while (_sequence.load(std::memory_order_relaxed) != sequence);
+
+        sample.unixTime       = words[0];
+        sample.rolloverMicros = words[1] | ((uint64_t)words[2] << 32);
+        sample.quarterDegrees = (int16_t)(words[3] & 0xFFFF);
+        sample.status         = (uint8_t)(words[3] >> 16);
+        sample.stale          = (words[3] >> 25) & 1;
+        return (words[3] >> 24) & 1;
+    }
+
+    /**
+     * Gets the current time, extrapolated from the last sample with CLOCK_MONOTONIC.
+     *
+     * @param seconds The variable that receives the number of seconds since 1970-01-01 00:00:00.
+     * @param micros  The variable that receives the fraction of the second, in microseconds.
+     * @return        True if a sample was published, or false, otherwise.
+     */
+    bool now(uint32_t& seconds, uint32_t& micros) const
+    {
+        TimeSample sample;
+        if (!read(sample))
+        {
+            return false;
+        }
+
+        uint64_t elapsed = monotonicMicros() - sample.rolloverMicros;
+        seconds = sample.unixTime + (uint32_t)(elapsed / 1000000);
+        micros  = (uint32_t)(elapsed % 1000000);
+        return true;
+    }
+
+    /**
+     * Gets the number of publications so far.
+     *
+     * @return The number of calls of publish().
+     */
+    uint32_t getPublishCount() const
+    {
+        return _sequence.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Gets the time of CLOCK_MONOTONIC, the time base of TimeSample::rolloverMicros.
+     *
+     * @return The number of microseconds since an arbitrary point (the same for all processes).
+     */
+    static uint64_t monotonicMicros()
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+    }
+
+private:
+    TimeSeqlock(const TimeSeqlock&);
+    TimeSeqlock& operator=(const TimeSeqlock&);
+
+    /**
+     * Stores the words of a sample in one of the copies.
+     *
+     * @param copy  The copy (0 or 1).
+     * @param words The words of the sample.
+     */
+    void store(uint8_t copy, const uint32_t* words)
+    {
+        for (uint8_t i = 0; i < RTC_SAMPLE_WORDS; i++)
+        {
+            _words[copy][i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Sequence number, incremented once per publication (its lowest bit selects the copy the readers use).
+     */
+    std::atomic<uint32_t> _sequence;
+
+    /**
+     * Two copies of the sample.
+     */
+    std::atomic<uint32_t> _words[2][RTC_SAMPLE_WORDS];
+};
+
+}} //end of namespace
+
+#endif //__linux__
+#endif //__AMPLIAR_DS3231_TIME_SEQLOCK_H__
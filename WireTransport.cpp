@@ -0,0 +1,255 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "WireTransport.h"
+
+#if defined(ARDUINO)
+
+#if defined(RTC_WIRE_ASYNC)
+#include <util/twi.h>
+
+#define RTC_TWCR_IDLE (_BV(TWEN) | _BV(TWIE) | _BV(TWEA)) ///< Control register of the Wire library, when it is idle
+#define RTC_TWCR_NEXT (_BV(TWEN) | _BV(TWINT))            ///< Starts the next step, with the TWI interrupt disabled
+#endif
+
+using namespace Ampliar::DS3231;
+
+/**
+ * Setups the I2C communication.
+ */
+void WireTransport::begin()
+{
+    Wire.begin();
+}
+
+/**
+ * Writes bytes to a device.
+ *
+ * @param address The I2C address of the device.
+ * @param data    The bytes to be written.
+ * @param length  The number of bytes.
+ * @return        True if the device acknowledged the transaction.
+ */
+bool WireTransport::write(uint8_t address, const uint8_t* data, uint8_t length)
+{
+#if defined(RTC_WIRE_ASYNC)
+    complete();
+#endif
+    Wire.beginTransmission(address);
+    Wire.write(data, length);
+    return Wire.endTransmission() == 0;
+}
+
+/**
+ * Writes bytes to a device and then reads its answer.
+ *
+ * The write and the read are separated by a repeated START, so no other master can take the bus in between.
+ *
+ * @param address  The I2C address of the device.
+ * @param tx       The bytes to be written (usually the register address).
+ * @param txLength The number of bytes to be written.
+ * @param rx       The buffer that will receive the bytes read.
+ * @param rxLength The number of bytes to be read.
+ * @return         True if all bytes were read.
+ */
+bool WireTransport::writeRead(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength)
+{
+#if defined(RTC_WIRE_ASYNC)
+    complete();
+#endif
+    Wire.beginTransmission(address);
+    Wire.write(tx, txLength);
+    if (Wire.endTransmission(false) != 0)
+    {
+        return false;
+    }
+
+    uint8_t received = Wire.requestFrom(address, rxLength);
+    for (uint8_t i = 0; i < received; i++)
+    {
+        rx[i] = (uint8_t)Wire.read();
+    }
+    return received == rxLength;
+}
+
+#if defined(RTC_WIRE_ASYNC)
+/**
+ * Starts a write followed by a read on the TWI hardware, without waiting for it to finish.
+ *
+ * The transaction is the same of writeRead(), with a repeated START between the write and the read. This method only
+ * requests the START condition: the transaction is advanced by poll().
+ *
+ * The buffers must remain valid until poll() reports that the transaction finished. A write() or writeRead() called
+ * meanwhile waits for it to finish first (its result is still reported by poll()).
+ *
+ * @param address  The I2C address of the device.
+ * @param tx       The bytes to be written (usually the register address).
+ * @param txLength The number of bytes to be written.
+ * @param rx       The buffer that will receive the bytes read.
+ * @param rxLength The number of bytes to be read.
+ * @return         True if the transaction was started, or false if another one is still pending or its result was
+ *                 not collected by poll() yet.
+ */
+bool WireTransport::beginWriteRead(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength)
+{
+    if (_state != TRANSFER_IDLE)
+    {
+        return false;
+    }
+
+    _address  = address;
+    _tx       = tx;
+    _txLength = txLength;
+    _rx       = rx;
+    _rxLength = rxLength;
+    _index    = 0;
+    _reading  = false;
+    _state    = TRANSFER_PENDING;
+
+    //The TWI interrupt stays disabled, so the interrupt handler of the Wire library does not take the transaction
+    TWCR = RTC_TWCR_NEXT | _BV(TWSTA);
+    return true;
+}
+
+/**
+ * Advances the transaction started by beginWriteRead().
+ *
+ * Each step of the transaction (a START condition or a byte) is executed by the TWI hardware. This method handles
+ * every step the hardware finished since the last call and starts the next one, so it never waits for the bus.
+ *
+ * TRANSFER_DONE or TRANSFER_FAILED is returned only once. After that, this method returns TRANSFER_IDLE until another
+ * transaction is started.
+ *
+ * @return The state of the transaction.
+ */
+BusTransport::TransferState WireTransport::poll()
+{
+    while (_state == TRANSFER_PENDING && (TWCR & _BV(TWINT)))
+    {
+        advance();
+    }
+
+    TransferState state = _state;
+    if (state != TRANSFER_PENDING)
+    {
+        _state = TRANSFER_IDLE;
+    }
+    return state;
+}
+
+/**
+ * Handles the step finished by the TWI hardware (TWINT is set) and starts the next one.
+ */
+void WireTransport::advance()
+{
+    switch (TW_STATUS)
+    {
+    case TW_START:
+    case TW_REP_START:
+        TWDR = (_address << 1) | (_reading ? TW_READ : TW_WRITE);
+        TWCR = RTC_TWCR_NEXT;
+        break;
+
+    case TW_MT_SLA_ACK:
+    case TW_MT_DATA_ACK:
+        if (_index < _txLength)
+        {
+            TWDR = _tx[_index++];
+            TWCR = RTC_TWCR_NEXT;
+        }
+        else if (_rxLength > 0)
+        {
+            //Repeated START: no other master can take the bus between the register address and the data
+            _reading = true;
+            _index   = 0;
+            TWCR     = RTC_TWCR_NEXT | _BV(TWSTA);
+        }
+        else
+        {
+            finish(TRANSFER_DONE, true);
+        }
+        break;
+
+    case TW_MR_DATA_ACK:
+        _rx[_index++] = TWDR;
+        //fall through
+    case TW_MR_SLA_ACK:
+        //The last byte is not acknowledged, which tells the device that the read is over
+        TWCR = _index + 1 < _rxLength ? (RTC_TWCR_NEXT | _BV(TWEA)) : RTC_TWCR_NEXT;
+        break;
+
+    case TW_MR_DATA_NACK:
+        _rx[_index++] = TWDR;
+        finish(TRANSFER_DONE, true);
+        break;
+
+    case TW_MT_ARB_LOST:
+        //Another master took the bus, so there is nothing to stop
+        finish(TRANSFER_FAILED, false);
+        break;
+
+    default:
+        //The address or a byte was not acknowledged, or a bus error
+        finish(TRANSFER_FAILED, true);
+        break;
+    }
+}
+
+/**
+ * Ends the transaction and gives the TWI hardware back to the Wire library.
+ *
+ * @param state The result of the transaction.
+ * @param stop  If true, a STOP condition is sent.
+ */
+void WireTransport::finish(TransferState state, bool stop)
+{
+    if (stop)
+    {
+        //The STOP condition takes a few microseconds and, like in the Wire library, it is awaited
+        TWCR = RTC_TWCR_IDLE | _BV(TWINT) | _BV(TWSTO);
+        while (TWCR & _BV(TWSTO))
+        {
+            //
+        }
+    }
+    else
+    {
+        TWCR = RTC_TWCR_IDLE | _BV(TWINT);
+    }
+    _state = state;
+}
+#endif //RTC_WIRE_ASYNC
+
+/**
+ * Waits for the transaction started by beginWriteRead(), if any, so the Wire library can use the bus.
+ *
+ * Call this method before using the global Wire object directly (or through another library) while an asynchronous
+ * read may be pending. The result of the read is still reported by poll(). On boards without asynchronous reads, this
+ * method does nothing.
+ */
+void WireTransport::complete()
+{
+#if defined(RTC_WIRE_ASYNC)
+    while (_state == TRANSFER_PENDING)
+    {
+        if (TWCR & _BV(TWINT))
+        {
+            advance();
+        }
+    }
+#endif
+}
+
+#endif //ARDUINO
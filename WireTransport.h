@@ -0,0 +1,121 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_WIRE_TRANSPORT_H__
+#define __AMPLIAR_DS3231_WIRE_TRANSPORT_H__
+
+#if defined(ARDUINO)
+
+#include <stdint.h>
+#include <Wire.h>
+#include "BusTransport.h"
+
+#if defined(__AVR__)
+#include <avr/io.h>
+#endif
+
+#if defined(TWCR)
+#define RTC_WIRE_ASYNC ///< Defined when asynchronous reads run on the TWI hardware, without blocking (AVR boards)
+#endif
+
+namespace Ampliar { namespace DS3231 {
+
+/**
+ * Bus transport based on the Arduino Wire library.
+ *
+ * This is the default transport on Arduino. It uses the global Wire object and a repeated START between the register
+ * address and the data read, so a register read is a single I2C transaction.
+ *
+ * On AVR boards with a TWI peripheral (e.g., Uno and Mega), asynchronous reads (see beginWriteRead()) do not block:
+ * they are driven directly on the TWI hardware, which sends each byte on its own, and poll() only hands the next byte
+ * to it. The Wire library owns the TWI interrupt, so the interrupt is kept disabled during these reads and the
+ * hardware is advanced by poll() instead. On other boards, asynchronous reads fall back to the blocking default of
+ * BusTransport.
+ *
+ * \b Note: While an asynchronous read is pending, the Wire library still sees an idle bus, so any other user of the
+ * global Wire object (another library, or the sketch itself) would corrupt both transactions. On a shared bus, call
+ * complete() before talking to other devices through Wire. Reads and writes of this class already do it.
+ *
+ * @author Daniel Murari Boatto
+ */
+class WireTransport : public BusTransport
+{
+public:
+#if defined(RTC_WIRE_ASYNC)
+    constexpr WireTransport():
+        _address(0), _tx(0), _txLength(0), _rx(0), _rxLength(0), _index(0), _reading(false), _state(TRANSFER_IDLE)
+    {
+    }
+#else
+    constexpr WireTransport() {}
+#endif
+    void begin();
+    bool write(uint8_t address, const uint8_t* data, uint8_t length);
+    bool writeRead(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength);
+    void complete();
+#if defined(RTC_WIRE_ASYNC)
+    bool beginWriteRead(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength);
+    TransferState poll();
+
+private:
+    void advance();
+    void finish(TransferState state, bool stop);
+
+    /**
+     * I2C address of the device of the asynchronous read.
+     */
+    uint8_t _address;
+
+    /**
+     * Bytes to be written before the read (usually the register address).
+     */
+    const uint8_t* _tx;
+
+    /**
+     * Number of bytes to be written.
+     */
+    uint8_t _txLength;
+
+    /**
+     * Buffer that receives the bytes read.
+     */
+    uint8_t* _rx;
+
+    /**
+     * Number of bytes to be read.
+     */
+    uint8_t _rxLength;
+
+    /**
+     * Number of bytes already written (or read, once _reading is set).
+     */
+    uint8_t _index;
+
+    /**
+     * True after the repeated START, while the bytes are read.
+     */
+    bool _reading;
+
+    /**
+     * State of the asynchronous read.
+     */
+    TransferState _state;
+#endif
+};
+
+}} //end of namespace
+
+#endif //ARDUINO
+#endif //__AMPLIAR_DS3231_WIRE_TRANSPORT_H__
@@ -0,0 +1,114 @@
+/**
+ * This example measures the I2C bus cost of every public method of
+ * this library. For each method, it prints how many transactions,
+ * bytes (including address bytes) and START/STOP conditions it
+ * needs, and an estimate of the bus time at 100 kHz and 400 kHz.
+ *
+ * Every method is measured twice: with the shadow cache disabled
+ * and enabled (see BaseClock::enableShadowCache()).
+ *
+ * The output is CSV, so it can be saved and compared whenever the
+ * library changes:
+ *
+ * method,cache,transactions,bytes,starts,stops,us_100khz,us_400khz
+ *
+ * By default, the methods run against the simulated DS3231 (class
+ * Simulator), so no hardware is required. Set USE_SIMULATOR to 0 to
+ * measure a real device. In this case, the wiring for Arduino Uno
+ * is (for other boards, check the Wire Library documentation to
+ * figure out the SDA and SCL pins on Arduino):
+ *
+ * +---------+--------+
+ * | Arduino | DS3231 |
+ * +---------+--------+
+ * | A4      | SDA    |
+ * | A5      | SCL    |
+ * | GND     | GND    |
+ * | 5V      | VCC    |
+ * +---------+--------+
+ *
+ * The same methods (see BusCostMethods.h) are also measured on a PC,
+ * against the simulated DS3231, by "make -C extras/tests".
+ *
+ * More information: https://github.com/dboatto/DS3231
+ *
+ * In order to use this example, open the Serial Monitor on
+ * Arduino IDE (Ctrl+Shit+M).
+ */
+#include <Arduino.h>
+#include "CountingTransport.h"
+#include "Simulator.h"
+#include "WireTransport.h"
+
+#define USE_SIMULATOR 1
+
+//All library classes are inside namespaces.
+//Therefore, use the following statement to import them.
+using namespace Ampliar::DS3231;
+
+#if USE_SIMULATOR
+Simulator device;
+#else
+WireTransport device;
+#endif
+
+//Every transaction goes through the counter before reaching the device.
+CountingTransport counter(device);
+
+// ---------------------------------------------------------------------------
+// Function prototypes
+// ---------------------------------------------------------------------------
+void measure(const char* method, void (*call)());
+// ---------------------------------------------------------------------------
+
+//The list of methods (see BusCostMethods.h) is shared with the host build.
+#include "BusCostMethods.h"
+
+void setup()
+{
+    Serial.begin(9600);
+
+    BaseClock::setTransport(counter);
+
+    Serial.println("method,cache,transactions,bytes,starts,stops,us_100khz,us_400khz");
+
+    BaseClock::disableShadowCache();
+    BusCost::measureAll();
+
+    BaseClock::enableShadowCache();
+    BaseClock::refresh();
+    BusCost::measureAll();
+}
+
+void loop()
+{
+    //
+}
+
+/**
+ * Measures one method and prints a CSV line with the results.
+ *
+ * @param method The name of the method.
+ * @param call   Function that calls the method.
+ */
+void measure(const char* method, void (*call)())
+{
+    counter.reset();
+    call();
+
+    Serial.print(method);
+    Serial.print(",");
+    Serial.print(BaseClock::isShadowCacheEnabled() ? "on" : "off");
+    Serial.print(",");
+    Serial.print(counter.getTransactions());
+    Serial.print(",");
+    Serial.print(counter.getBytes());
+    Serial.print(",");
+    Serial.print(counter.getStarts());
+    Serial.print(",");
+    Serial.print(counter.getStops());
+    Serial.print(",");
+    Serial.print(counter.getBusTimeMicros(100000));
+    Serial.print(",");
+    Serial.println(counter.getBusTimeMicros(400000));
+}
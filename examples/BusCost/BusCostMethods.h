@@ -0,0 +1,97 @@
+/**
+ * The methods measured by the BusCost example.
+ *
+ * They are kept apart from BusCost.ino, so the same list is also
+ * measured on the host, against the simulated DS3231, by
+ * extras/tests/test_BusCost.cpp. Before including this file, declare
+ * the function that measures one method:
+ *
+ * void measure(const char* method, void (*call)());
+ *
+ * More information: https://github.com/dboatto/DS3231
+ */
+#ifndef __AMPLIAR_DS3231_BUS_COST_METHODS_H__
+#define __AMPLIAR_DS3231_BUS_COST_METHODS_H__
+
+#include "RealTimeClock.h"
+#include "RealTimeClockController.h"
+#include "Alarm1.h"
+#include "Alarm2.h"
+#include "TemperatureCache.h"
+
+namespace BusCost {
+
+using namespace Ampliar::DS3231;
+
+RealTimeClock clock;
+RealTimeClockController controller;
+Alarm1 alarm1;
+Alarm2 alarm2;
+TemperatureCache temperature;
+RegisterSnapshot snapshot;
+
+/**
+ * Measures all public methods.
+ */
+void measureAll()
+{
+    measure("RealTimeClock::readDateTime", [] { clock.readDateTime(); });
+    measure("RealTimeClock::readNow", [] { clock.readNow(); });
+    measure("RealTimeClock::readUnixTime", [] { clock.readUnixTime(); });
+    measure("RealTimeClock::writeDateTime", [] { clock.writeDateTime(2015, 12, 27, 16, 28, 0); });
+    measure("RealTimeClock::wasItStopped", [] { clock.wasItStopped(); });
+    measure("RealTimeClock::forceTemperatureUpdate", [] { clock.forceTemperatureUpdate(); });
+    measure("RealTimeClock::readTemperature", [] { clock.readTemperature(); });
+    measure("RealTimeClock::readTemperatureQuarterDegrees", [] { clock.readTemperatureQuarterDegrees(); });
+    measure("BaseClock::readSnapshot", [] { BaseClock::readSnapshot(snapshot); });
+    measure("BaseClock::pollEvents", [] { BaseClock::pollEvents(); });
+    //
+    measure("TemperatureCache::read(expired)", [] { temperature.expire(); temperature.read(); });
+    measure("TemperatureCache::read(cached)", [] { temperature.read(); });
+    measure("TemperatureCache::requestConversion", [] { temperature.requestConversion(); });
+    measure("TemperatureCache::isConversionDone", [] { temperature.isConversionDone(); });
+    //
+    measure("Alarm1::readAlarm", [] { alarm1.readAlarm(); });
+    measure("Alarm1::writeAlarmOncePerSecond", [] { alarm1.writeAlarmOncePerSecond(); });
+    measure("Alarm1::writeAlarm(s)", [] { alarm1.writeAlarm(10); });
+    measure("Alarm1::writeAlarm(m,s)", [] { alarm1.writeAlarm(20, 10); });
+    measure("Alarm1::writeAlarm(h,m,s)", [] { alarm1.writeAlarm(21, 20, 10); });
+    measure("Alarm1::writeAlarm(d,h,m,s)", [] { alarm1.writeAlarm(false, 27, 21, 20, 10); });
+    measure("Alarm1::arm(h,m,s)", [] { alarm1.arm(21, 20, 10); });
+    measure("Alarm1::isOn", [] { alarm1.isOn(); });
+    measure("Alarm1::turnOn", [] { alarm1.turnOn(true); });
+    measure("Alarm1::turnOff", [] { alarm1.turnOff(); });
+    measure("Alarm1::wasItTriggered", [] { alarm1.wasItTriggered(); });
+    measure("Alarm1::clearAlarmFlag", [] { alarm1.clearAlarmFlag(); });
+    //
+    measure("Alarm2::readAlarm", [] { alarm2.readAlarm(); });
+    measure("Alarm2::writeAlarmOncePerMinute", [] { alarm2.writeAlarmOncePerMinute(); });
+    measure("Alarm2::writeAlarm(m)", [] { alarm2.writeAlarm(20); });
+    measure("Alarm2::writeAlarm(h,m)", [] { alarm2.writeAlarm(21, 20); });
+    measure("Alarm2::writeAlarm(d,h,m)", [] { alarm2.writeAlarm(false, 27, 21, 20); });
+    measure("Alarm2::arm(h,m)", [] { alarm2.arm(21, 20); });
+    measure("Alarm2::isOn", [] { alarm2.isOn(); });
+    measure("Alarm2::turnOn", [] { alarm2.turnOn(true); });
+    measure("Alarm2::turnOff", [] { alarm2.turnOff(); });
+    measure("Alarm2::wasItTriggered", [] { alarm2.wasItTriggered(); });
+    measure("Alarm2::clearAlarmFlag", [] { alarm2.clearAlarmFlag(); });
+    //
+    measure("RealTimeClockController::enableBattery", [] { controller.enableBattery(); });
+    measure("RealTimeClockController::disableBattery", [] { controller.disableBattery(); });
+    measure("RealTimeClockController::isBatteryEnabled", [] { controller.isBatteryEnabled(); });
+    measure("RealTimeClockController::enable32khzOutput", [] { controller.enable32khzOutput(); });
+    measure("RealTimeClockController::disable32khzOutput", [] { controller.disable32khzOutput(); });
+    measure("RealTimeClockController::is32khzOutputEnabled", [] { controller.is32khzOutputEnabled(); });
+    measure("RealTimeClockController::enableSquareWave", [] { controller.enableSquareWave(RealTimeClockController::FREQ_1HZ); });
+    measure("RealTimeClockController::disableSquareWave", [] { controller.disableSquareWave(); });
+    measure("RealTimeClockController::isSquareWaveEnabled", [] { controller.isSquareWaveEnabled(); });
+    measure("RealTimeClockController::getSquareWaveFrequency", [] { controller.getSquareWaveFrequency(); });
+    measure("RealTimeClockController::enableBatteryBackedSquareWave", [] { controller.enableBatteryBackedSquareWave(RealTimeClockController::FREQ_1HZ); });
+    measure("RealTimeClockController::disableBatteryBackedSquareWave", [] { controller.disableBatteryBackedSquareWave(); });
+    measure("RealTimeClockController::isBatteryBackedSquareWaveEnabled", [] { controller.isBatteryBackedSquareWaveEnabled(); });
+    measure("RealTimeClockController::writeCalibration", [] { controller.writeCalibration(0); });
+    measure("RealTimeClockController::readCalibration", [] { controller.readCalibration(); });
+}
+
+} //end of namespace
+#endif //__AMPLIAR_DS3231_BUS_COST_METHODS_H__
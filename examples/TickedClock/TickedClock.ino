@@ -0,0 +1,78 @@
+/**
+ * This example shows how to keep the date/time in RAM, advanced by the
+ * 1 Hz square-wave output of DS3231, so reading the date/time costs no
+ * I2C traffic. The date/time is only read over I2C at startup, once
+ * every hour, and when a tick is missed.
+ *
+ * Wiring for Arduino Uno (for other boards, check the Wire
+ * Library documentation to figure out the SDA and SCL pins
+ * on Arduino):
+ *
+ * +---------+---------+
+ * | Arduino | DS3231  |
+ * +---------+---------+
+ * | A4      | SDA     |
+ * | A5      | SCL     |
+ * | 2       | INT/SQW |
+ * | GND     | GND     |
+ * | 5V      | VCC     |
+ * +---------+---------+
+ *
+ * More information: https://github.com/dboatto/DS3231
+ *
+ * In order to use this example, open the Serial Monitor on
+ * Arduino IDE (Ctrl+Shit+M).
+ */
+#include <Arduino.h>
+#include "TickedClock.h"
+
+//All library classes are inside namespaces.
+//Therefore, use the following statement to import them.
+using namespace Ampliar::DS3231;
+
+//This statement creates an instance of TickedClock, which keeps a copy of
+//the date/time in RAM.
+TickedClock clock;
+
+//Called on every falling edge of the INT/SQW pin.
+void onSquareWave()
+{
+    clock.tick();
+}
+
+void setup()
+{
+    Serial.begin(9600);
+
+    //INT/SQW is an open-drain output, therefore the pull-up resistor.
+    pinMode(2, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(2), onSquareWave, FALLING);
+
+    //Enables the 1 Hz square wave and reads the date/time over I2C.
+    //Usage: begin(number of seconds between two resyncs);
+    clock.begin(3600);
+}
+
+void loop()
+{
+    //Applies the ticks. It only accesses the I2C bus when a resync is due.
+    clock.update();
+
+    //The getters below are just RAM reads.
+    Serial.print(clock.getDay());
+    Serial.print("/");
+    Serial.print(clock.getMonth());
+    Serial.print("/");
+    Serial.print(clock.getYear());
+    Serial.print(" ");
+    Serial.print(clock.getHour());
+    Serial.print(":");
+    Serial.print(clock.getMinute());
+    Serial.print(":");
+    Serial.print(clock.getSecond());
+    Serial.print(" (resyncs: ");
+    Serial.print(clock.getResyncCount());
+    Serial.println(")");
+
+    delay(250);
+}
@@ -0,0 +1,140 @@
+/**
+ * rtcd: shared memory time service for Linux.
+ *
+ * This daemon is the only reader of a DS3231. Once per second, just
+ * after the seconds rollover, it reads the date/time, the temperature
+ * and the status flags in a single I2C transaction (see SharedClock)
+ * and publishes them in a POSIX shared memory segment (see
+ * SharedTimeSegment.h). Any number of processes read the segment
+ * with SharedTimeClient, a header-only class, without system calls
+ * and without opening the bus.
+ *
+ * Usage:
+ *
+ * rtcd [-b bus] [-a address] [-n name]
+ *
+ * -b  The i2c-dev character device (default: /dev/i2c-1).
+ * -a  The I2C address of DS3231 (default: 0x68).
+ * -n  The shared memory name (default: /ds3231, i.e., /dev/shm/ds3231).
+ *
+ * The daemon runs in the foreground until SIGINT or SIGTERM. Only one
+ * daemon can publish in a segment (a second one exits). The segment
+ * is kept when the daemon exits, so clients keep it mapped and see
+ * new samples again when the daemon is restarted (meanwhile,
+ * SharedTimeClient::isAlive() returns false).
+ *
+ * Build (from this directory):
+ *
+ * g++ -O2 -I../.. rtcd.cpp ../../[A-Z]*.cpp -lpthread -lrt -o rtcd
+ *
+ * More information: https://github.com/dboatto/DS3231
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <sys/file.h>
+#include "Device.h"
+#include "LinuxI2cTransport.h"
+#include "RealTimeClock.h"
+#include "RegisterSnapshot.h"
+#include "SharedClock.h"
+#include "SharedTimeSegment.h"
+
+using namespace Ampliar::DS3231;
+
+/**
+ * Creates (or reuses) the shared memory segment and locks it against other daemons.
+ *
+ * @param name The shared memory name.
+ * @return     The segment, or null on failure.
+ */
+static SharedTimeSegment* createSegment(const char* name)
+{
+    int fd = shm_open(name, O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+    {
+        perror("shm_open");
+        return 0;
+    }
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0)
+    {
+        fprintf(stderr, "rtcd: %s is already published by another daemon\n", name);
+        close(fd);
+        return 0;
+    }
+    if (ftruncate(fd, sizeof(SharedTimeSegment)) != 0)
+    {
+        perror("ftruncate");
+        close(fd);
+        return 0;
+    }
+
+    void* memory = mmap(0, sizeof(SharedTimeSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED)
+    {
+        perror("mmap");
+        close(fd);
+        return 0;
+    }
+    //The descriptor is kept open (and locked) until the daemon exits
+    return SharedTimeSegment::initialize(memory);
+}
+
+int main(int argc, char** argv)
+{
+    const char* bus  = "/dev/i2c-1";
+    const char* name = RTC_SEGMENT_NAME;
+    uint8_t address  = RTC_ADDR_I2C;
+    int option;
+    while ((option = getopt(argc, argv, "b:a:n:")) != -1)
+    {
+        switch (option)
+        {
+            case 'b': bus     = optarg; break;
+            case 'a': address = (uint8_t)strtoul(optarg, 0, 0); break;
+            case 'n': name    = optarg; break;
+            default:
+                fprintf(stderr, "usage: %s [-b bus] [-a address] [-n name]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    LinuxI2cTransport transport(bus);
+    Device device(transport, address);
+    RealTimeClock clock(device); //starts the transport
+    RegisterSnapshot snapshot;
+    if (!transport.isOpen() || !device.readSnapshot(snapshot))
+    {
+        fprintf(stderr, "rtcd: no DS3231 at 0x%02X on %s\n", address, bus);
+        return 1;
+    }
+    if (snapshot.wasItStopped())
+    {
+        fprintf(stderr, "rtcd: warning: the oscillator was stopped, the time may be invalid\n");
+    }
+
+    SharedTimeSegment* segment = createSegment(name);
+    if (!segment)
+    {
+        return 1;
+    }
+
+    //The poller thread inherits the mask, so the signals are only taken by sigwait()
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, 0);
+
+    SharedClock shared(device, &segment->seqlock);
+    if (!shared.start())
+    {
+        fprintf(stderr, "rtcd: could not start the poller thread\n");
+        return 1;
+    }
+
+    int signal;
+    sigwait(&signals, &signal);
+    shared.stop();
+    return 0;
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AMPLIAR_DS3231_TESTS_CHECK_H__
+#define __AMPLIAR_DS3231_TESTS_CHECK_H__
+
+#include <stdio.h>
+
+/**
+ * Minimal checks for the host tests.
+ *
+ * CHECK() prints the failed condition and counts it, without stopping the test, and CHECK_RESULT() is returned by
+ * main(): zero if all checks passed.
+ */
+static int checkFailures = 0;
+
+#define CHECK(condition)                                                                 \
+    do                                                                                   \
+    {                                                                                    \
+        if (!(condition))                                                                \
+        {                                                                                \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);         \
+            checkFailures++;                                                             \
+        }                                                                                \
+    }                                                                                    \
+    while (0)
+
+#define CHECK_RESULT() (checkFailures == 0 ? 0 : 1)
+
+#endif //__AMPLIAR_DS3231_TESTS_CHECK_H__
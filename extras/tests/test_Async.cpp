@@ -0,0 +1,163 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Check.h"
+#include "Alarm1.h"
+#include "Device.h"
+#include "RealTimeClock.h"
+#include "Simulator.h"
+
+using namespace Ampliar::DS3231;
+
+/**
+ * Results reported by the callbacks.
+ */
+struct Result
+{
+    uint8_t calls;
+    bool success;
+    int16_t quarterDegrees;
+};
+
+void onDateTime(const RealTimeClock&, bool success, void* context)
+{
+    Result* result = static_cast<Result*>(context);
+    result->calls++;
+    result->success = success;
+}
+
+void onTemperature(int16_t quarterDegrees, bool success, void* context)
+{
+    Result* result = static_cast<Result*>(context);
+    result->calls++;
+    result->success        = success;
+    result->quarterDegrees = quarterDegrees;
+}
+
+void onAlarm(const BaseAlarm&, bool success, void* context)
+{
+    Result* result = static_cast<Result*>(context);
+    result->calls++;
+    result->success = success;
+}
+
+int main()
+{
+    Simulator simulator;
+    simulator.powerOn();
+    simulator.setTransferLatency(3);
+    BaseClock::setTransport(simulator);
+
+    RealTimeClock clock;
+    clock.writeDateTime(2030, 6, 15, 8, 15, 30);
+
+    //The read stays pending while the transport works, and only one read may be pending
+    Result result = Result();
+    CHECK(clock.readDateTimeAsync(onDateTime, &result));
+    CHECK(BaseClock::isReadPending());
+    CHECK(!clock.readTemperatureAsync(onTemperature, &result));
+    uint8_t polls = 0;
+    while (BaseClock::isReadPending() && polls < 10)
+    {
+        BaseClock::poll();
+        polls++;
+    }
+    CHECK(polls == 4);
+    CHECK(result.calls == 1 && result.success);
+    CHECK(clock.getYear() == 2030 && clock.getMonth() == 6 && clock.getDay() == 15);
+    CHECK(clock.getHour() == 8 && clock.getMinute() == 15 && clock.getSecond() == 30);
+
+    //The registers are read when the transfer finishes, not when it starts
+    CHECK(clock.readDateTimeAsync(onDateTime, &result));
+    simulator.advance(2000);
+    while (BaseClock::poll())
+    {
+        //
+    }
+    CHECK(result.calls == 2 && clock.getSecond() == 32);
+
+    simulator.setTemperature(-37);
+    clock.forceTemperatureUpdate();
+    simulator.advance(RTC_SIM_CONVERSION_MICROS / 1000);
+    CHECK(clock.readTemperatureAsync(onTemperature, &result));
+    while (BaseClock::poll())
+    {
+        //
+    }
+    CHECK(result.calls == 3 && result.success && result.quarterDegrees == -37);
+
+    Alarm1 alarm;
+    alarm.writeAlarm(21, 20, 10);
+    CHECK(alarm.readAlarmAsync(onAlarm, &result));
+    while (BaseClock::poll())
+    {
+        //
+    }
+    CHECK(result.calls == 4 && result.success);
+    CHECK(alarm.getHour() == 21 && alarm.getMinute() == 20 && alarm.getSecond() == 10);
+
+    //A device that does not answer fails the reads, and the clock is left unchanged
+    Device missing(simulator, 0x57);
+    RealTimeClock lost(missing);
+    CHECK(lost.readDateTimeAsync(onDateTime, &result));
+    CHECK(missing.isReadPending() && !BaseClock::isReadPending());
+    while (missing.poll())
+    {
+        //
+    }
+    CHECK(result.calls == 5 && !result.success && lost.getYear() == 0);
+    CHECK(lost.readTemperatureAsync(onTemperature, &result));
+    while (missing.poll())
+    {
+        //
+    }
+    CHECK(result.calls == 6 && !result.success && result.quarterDegrees == RTC_TEMPERATURE_INVALID);
+    CHECK(!missing.isReadPending());
+
+    //Devices on different buses have their own pending reads
+    Simulator otherSimulator;
+    otherSimulator.powerOn();
+    otherSimulator.setTransferLatency(1);
+    Device other(otherSimulator);
+    RealTimeClock otherClock(other);
+    otherClock.writeDateTime(2040, 2, 29, 23, 59, 0);
+    Result otherResult = Result();
+    CHECK(clock.readDateTimeAsync(onDateTime, &result));
+    CHECK(otherClock.readDateTimeAsync(onDateTime, &otherResult));
+    while (BaseClock::poll() | other.poll())
+    {
+        //
+    }
+    CHECK(result.calls == 7 && result.success && clock.getYear() == 2030);
+    CHECK(otherResult.calls == 1 && otherResult.success && otherClock.getYear() == 2040);
+
+    //Devices on the same bus share its transfer, so the second read waits for the first one to be collected
+    CHECK(clock.readDateTimeAsync(onDateTime, &result));
+    CHECK(!lost.readDateTimeAsync(onDateTime, &result));
+    while (BaseClock::poll())
+    {
+        //
+    }
+    CHECK(result.calls == 8 && result.success);
+    CHECK(lost.readDateTimeAsync(onDateTime, &result));
+    while (missing.poll())
+    {
+        //
+    }
+    CHECK(result.calls == 9 && !result.success);
+    CHECK(!BaseClock::isReadPending() && !missing.isReadPending() && !other.isReadPending());
+
+    return CHECK_RESULT();
+}
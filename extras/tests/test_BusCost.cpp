@@ -0,0 +1,132 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string.h>
+#include "Check.h"
+#include "CountingTransport.h"
+#include "Simulator.h"
+
+/**
+ * Host build of the BusCost example: the same methods are measured through CountingTransport, against the simulated
+ * device, and the costs of the single-transaction methods are checked.
+ *
+ * Run "build/test_BusCost --csv" to print the CSV of the example.
+ */
+void measure(const char* method, void (*call)());
+#include "../../examples/BusCost/BusCostMethods.h"
+
+using namespace Ampliar::DS3231;
+
+Simulator device;
+CountingTransport counter(device);
+bool printCsv = false;
+
+/**
+ * Cost of one method, with the shadow cache disabled ([0]) and enabled ([1]).
+ */
+struct Cost
+{
+    const char* method;
+    uint32_t transactions[2];
+};
+
+Cost costs[64];
+uint8_t costCount = 0;
+
+void measure(const char* method, void (*call)())
+{
+    counter.reset();
+    call();
+
+    bool cache = BaseClock::isShadowCacheEnabled();
+    if (printCsv)
+    {
+        printf("%s,%s,%u,%u,%u,%u,%u,%u\n", method, cache ? "on" : "off", (unsigned)counter.getTransactions(),
+               (unsigned)counter.getBytes(), (unsigned)counter.getStarts(), (unsigned)counter.getStops(),
+               (unsigned)counter.getBusTimeMicros(100000), (unsigned)counter.getBusTimeMicros(400000));
+    }
+
+    uint8_t i = 0;
+    while (i < costCount && strcmp(costs[i].method, method) != 0)
+    {
+        i++;
+    }
+    if (i == costCount && costCount < sizeof(costs) / sizeof(costs[0]))
+    {
+        costs[costCount++].method = method;
+    }
+    costs[i].transactions[cache] = counter.getTransactions();
+}
+
+/**
+ * Gets the number of transactions of a method.
+ */
+uint32_t transactions(const char* method, bool cache)
+{
+    for (uint8_t i = 0; i < costCount; i++)
+    {
+        if (strcmp(costs[i].method, method) == 0)
+        {
+            return costs[i].transactions[cache];
+        }
+    }
+    return 0xFFFFFFFFUL;
+}
+
+int main(int argc, char** argv)
+{
+    printCsv = argc > 1 && strcmp(argv[1], "--csv") == 0;
+
+    device.powerOn();
+    BaseClock::setTransport(counter);
+
+    if (printCsv)
+    {
+        printf("method,cache,transactions,bytes,starts,stops,us_100khz,us_400khz\n");
+    }
+
+    BaseClock::disableShadowCache();
+    BusCost::measureAll();
+
+    BaseClock::enableShadowCache();
+    BaseClock::refresh();
+    BusCost::measureAll();
+
+    for (uint8_t cache = 0; cache < 2; cache++)
+    {
+        CHECK(transactions("RealTimeClock::readDateTime", cache) == 1);
+        CHECK(transactions("RealTimeClock::readNow", cache) == 1);
+        CHECK(transactions("RealTimeClock::readUnixTime", cache) == 1);
+        CHECK(transactions("RealTimeClock::readTemperatureQuarterDegrees", cache) == 1);
+        CHECK(transactions("BaseClock::readSnapshot", cache) == 1);
+        CHECK(transactions("BaseClock::pollEvents", cache) == 1);
+        CHECK(transactions("TemperatureCache::read(expired)", cache) == 1);
+        CHECK(transactions("TemperatureCache::read(cached)", cache) == 0);
+        CHECK(transactions("Alarm1::readAlarm", cache) == 1);
+        CHECK(transactions("Alarm2::readAlarm", cache) == 1);
+    }
+
+    //With a warm cache, arming an alarm is a single burst, and reading the configuration costs nothing
+    CHECK(transactions("Alarm1::arm(h,m,s)", true) == 1);
+    CHECK(transactions("Alarm2::arm(h,m)", true) == 1);
+    CHECK(transactions("Alarm1::arm(h,m,s)", false) == 2);
+    CHECK(transactions("Alarm2::arm(h,m)", false) == 2);
+    CHECK(transactions("Alarm1::isOn", true) == 0);
+    CHECK(transactions("RealTimeClockController::isBatteryEnabled", true) == 0);
+    CHECK(transactions("RealTimeClockController::readCalibration", true) == 0);
+    CHECK(transactions("RealTimeClockController::enableBattery", true) == 1);
+
+    return CHECK_RESULT();
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Check.h"
+#include "CronSchedule.h"
+#include "Simulator.h"
+
+using namespace Ampliar::DS3231;
+
+Simulator simulator;
+RealTimeClock realTimeClock;
+Alarm2 alarm;
+
+/**
+ * Runs a schedule on the simulated device for a number of days, minute by minute, and checks that it is due exactly
+ * at the minutes that match the expression.
+ *
+ * @return The number of minutes at which the schedule was due.
+ */
+uint32_t run(const char* expression, uint16_t days)
+{
+    CronSchedule schedule;
+    CHECK(schedule.parse(expression));
+
+    realTimeClock.writeDateTime(2024, 1, 1, 0, 0, 0);
+    schedule.writeAlarm(alarm);
+    alarm.clearAlarmFlag();
+    alarm.turnOn(true);
+
+    uint32_t due = 0;
+    for (uint32_t minute = 0; minute < days * 24UL * 60; minute++)
+    {
+        simulator.advanceSeconds(60);
+        bool isDue = schedule.isDue(alarm, realTimeClock);
+        realTimeClock.readDateTime();
+        if (isDue != schedule.matches(realTimeClock))
+        {
+            printf("%s: due=%d at %02u-%02u %02u:%02u\n", expression, isDue, realTimeClock.getMonth(), realTimeClock.getDay(),
+                   realTimeClock.getHour(), realTimeClock.getMinute());
+            CHECK(false);
+            break;
+        }
+        due += isDue;
+    }
+    return due;
+}
+
+int main()
+{
+    simulator.powerOn();
+    BaseClock::setTransport(simulator);
+
+    //Steps are not restricted fields (the day fields are ANDed), but they do not match every day
+    CronSchedule schedule;
+    CHECK(schedule.parse("0 0 */2 * *") && schedule.hasResidual());
+    CHECK(schedule.parse("0 0 * * */2") && schedule.hasResidual());
+    CHECK(schedule.parse("0 0 1 * */2") && schedule.hasResidual());
+    CHECK(schedule.getAlarmRate() == Alarm2::WHEN_MINUTES_AND_HOURS_AND_DAY_MATCH);
+    CHECK(schedule.parse("0 0 */2 * 1") && schedule.hasResidual());
+    CHECK(schedule.getAlarmRate() == Alarm2::WHEN_MINUTES_AND_HOURS_AND_DAY_OF_WEEK_MATCH);
+
+    //Days that match either field, or every day
+    CHECK(schedule.parse("0 0 1 * 1") && schedule.hasResidual());
+    CHECK(schedule.parse("0 0 1-31 * 1") && !schedule.hasResidual());
+    CHECK(schedule.parse("0 0 * * *") && !schedule.hasResidual());
+    CHECK(schedule.parse("0 0 1 * *") && !schedule.hasResidual());
+
+    //A year (2024 is a leap year), with days matching either field (Fridays and the 13th) in the last cases
+    CHECK(run("0 0 */2 * *", 366) == 187);
+    CHECK(run("0 0 * * */2", 366) == 209);
+    CHECK(run("30 12 1 * */2", 366) == 6);
+    CHECK(run("0 6 */2 * 1", 366) == 27);
+    CHECK(run("0 12 */10 * 1", 366) == 6);
+    CHECK(run("0 12 */10 * 1,3", 366) == 13);
+    CHECK(run("0 12 13 * 5", 366) == 62);
+    CHECK(run("15 */6 * * *", 7) == 28);
+
+    return CHECK_RESULT();
+}
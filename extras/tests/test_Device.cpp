@@ -0,0 +1,106 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Check.h"
+#include "AlarmScheduler.h"
+#include "Device.h"
+#include "Simulator.h"
+#include "SubSecondClock.h"
+
+using namespace Ampliar::DS3231;
+
+uint8_t jobs = 0;
+
+/**
+ * Bus whose reads fail, while its writes still reach the device.
+ */
+class FailingReads : public BusTransport
+{
+public:
+    explicit FailingReads(Simulator& simulator): _simulator(simulator), writes(0) {}
+    void begin() {}
+    bool write(uint8_t address, const uint8_t* data, uint8_t length)
+    {
+        writes++;
+        return _simulator.write(address, data, length);
+    }
+    bool writeRead(uint8_t, const uint8_t*, uint8_t, uint8_t*, uint8_t) { return false; }
+
+private:
+    Simulator& _simulator;
+
+public:
+    uint8_t writes;
+};
+
+void onJob(uint32_t, void*)
+{
+    jobs++;
+}
+
+int main()
+{
+    //The helpers built on a device never touch the default one
+    Simulator simulator;
+    Simulator other;
+    simulator.powerOn();
+    other.powerOn();
+    BaseClock::setTransport(other);
+    Device device(simulator);
+    RealTimeClock clock(device);
+    RealTimeClockController controller(device);
+    RealTimeClockController defaultController;
+
+    clock.writeDateTime(2030, 6, 15, 8, 15, 30);
+    SubSecondClock subSecond(device);
+    subSecond.begin();
+    CHECK(subSecond.getYear() == 2030 && subSecond.getMinute() == 15 && subSecond.getSecond() == 30);
+    CHECK(controller.isSquareWaveEnabled());
+    CHECK(controller.getSquareWaveFrequency() == RealTimeClockController::FREQ_1HZ);
+    CHECK(!defaultController.isSquareWaveEnabled());
+
+    AlarmScheduler scheduler(device);
+    scheduler.begin(false);
+    CHECK(scheduler.scheduleIn(90, onJob, 0));
+    simulator.advanceSeconds(91);
+    scheduler.update();
+    CHECK(jobs == 1);
+    CHECK(!Alarm1().isOn() && Alarm1(device).isOn());
+
+    //A failed read never turns into a write of a register rebuilt from zero
+    FailingReads failingBus(simulator);
+    Device failing(failingBus);
+    uint8_t control = simulator.peekRegister(RTC_ADDR_CONTROL);
+    uint8_t status  = simulator.peekRegister(RTC_ADDR_STATUS);
+    int8_t offset   = 5;
+    CHECK(!RealTimeClockController(failing).enableBattery());
+    CHECK(!RealTimeClockController(failing).disableSquareWave());
+    CHECK(!RealTimeClockController(failing).enable32khzOutput());
+    CHECK(!RealTimeClockController(failing).readCalibration(offset) && offset == 5);
+    CHECK(!Alarm1(failing).turnOff() && !Alarm1(failing).clearAlarmFlag() && !Alarm1(failing).wasItTriggered());
+    CHECK(!RealTimeClock(failing).forceTemperatureUpdate());
+    CHECK(RealTimeClock(failing).wasItStopped());
+    CHECK(failing.pollEvents() == RTC_EVENT_OSCILLATOR_STOPPED);
+
+    //Nor is a failed read of the time taken as 1970
+    AlarmScheduler failingScheduler(failing);
+    CHECK(!failingScheduler.scheduleIn(90, onJob, 0) && failingScheduler.getJobCount() == 0);
+    CHECK(failingScheduler.schedule(1, onJob, 0) && jobs == 1);
+    CHECK(!failingScheduler.update(true) && jobs == 1 && failingScheduler.getArmedTime() == 0);
+    CHECK(failingBus.writes == 0);
+    CHECK(simulator.peekRegister(RTC_ADDR_CONTROL) == control && simulator.peekRegister(RTC_ADDR_STATUS) == status);
+
+    return CHECK_RESULT();
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <math.h>
+#include "Check.h"
+#include "Device.h"
+#include "DriftEstimator.h"
+#include "Simulator.h"
+
+using namespace Ampliar::DS3231;
+
+/**
+ * Observes the device once a day, against a reference that is exactly the virtual time of the simulator.
+ */
+void observeDays(DriftEstimator& estimator, Simulator& simulator, RealTimeClock& clock, uint32_t& referenceTime,
+                 uint16_t days)
+{
+    for (uint16_t day = 0; day < days; day++)
+    {
+        simulator.advanceSeconds(86400);
+        referenceTime += 86400;
+        CHECK(estimator.observe(clock, referenceTime));
+    }
+}
+
+int main()
+{
+    //The estimator drives a device that is not the default one, which stays untouched
+    Simulator simulator;
+    Simulator other;
+    simulator.powerOn();
+    other.powerOn();
+    BaseClock::setTransport(other);
+    Device device(simulator);
+    RealTimeClock clock(device);
+    RealTimeClockController controller(device);
+
+    //The device runs 2.3 ppm fast
+    simulator.setDrift(2300);
+    clock.writeDateTime(2030, 1, 1, 0, 0, 0);
+    uint32_t referenceTime = clock.readUnixTime();
+
+    DriftEstimator estimator;
+    CHECK(estimator.observe(clock, referenceTime));
+    observeDays(estimator, simulator, clock, referenceTime, 60);
+    CHECK(estimator.getObservationCount() == 61);
+    CHECK(fabs(estimator.getDriftPpm() - 2.3) < 0.05);
+    CHECK(estimator.getUncertaintyPpm() < RTC_DRIFT_MAX_UNCERTAINTY);
+
+    CHECK(estimator.applyAgingOffset(clock));
+    CHECK(controller.readCalibration() == 23);
+    CHECK(RealTimeClockController().readCalibration() == 0);
+    CHECK(estimator.getObservationCount() == 0);
+
+    //With the new offset, the drift is cancelled, so the offset is kept
+    referenceTime = clock.readUnixTime();
+    CHECK(estimator.observe(clock, referenceTime));
+    observeDays(estimator, simulator, clock, referenceTime, 60);
+    CHECK(fabs(estimator.getDriftPpm()) < 0.05);
+    CHECK(!estimator.applyAgingOffset(clock));
+    CHECK(controller.readCalibration() == 23);
+
+    //A device that does not answer gives no observations
+    Device missing(simulator, 0x57);
+    RealTimeClock lost(missing);
+    CHECK(!estimator.observe(lost, referenceTime + 1));
+
+    return CHECK_RESULT();
+}
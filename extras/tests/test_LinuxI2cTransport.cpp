@@ -0,0 +1,121 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string.h>
+#include "Check.h"
+#include "LinuxI2cTransport.h"
+#include "RealTimeClock.h"
+#include "Simulator.h"
+
+using namespace Ampliar::DS3231;
+
+/**
+ * Transport that records the messages of each transfer, instead of issuing the ioctl, and executes them on the
+ * simulated device.
+ */
+class RecordingTransport : public LinuxI2cTransport
+{
+public:
+    RecordingTransport(Simulator& simulator):
+        LinuxI2cTransport(-1), simulator(simulator), count(0), fail(false)
+    {
+    }
+
+    Simulator& simulator;
+    struct i2c_msg messages[2];
+    uint8_t data[2][32];
+    uint32_t count;
+    bool fail;
+
+protected:
+    bool transfer(struct i2c_msg* sent, uint32_t sentCount)
+    {
+        count = sentCount;
+        for (uint32_t i = 0; i < sentCount && i < 2; i++)
+        {
+            messages[i] = sent[i];
+            if (!(sent[i].flags & I2C_M_RD))
+            {
+                memcpy(data[i], sent[i].buf, sent[i].len);
+            }
+        }
+        if (fail)
+        {
+            return false;
+        }
+        if (sentCount == 1)
+        {
+            return simulator.write(sent[0].addr, sent[0].buf, sent[0].len);
+        }
+        return simulator.writeRead(sent[0].addr, sent[0].buf, sent[0].len, sent[1].buf, sent[1].len);
+    }
+};
+
+int main()
+{
+    Simulator simulator;
+    simulator.powerOn();
+    RecordingTransport transport(simulator);
+
+    //A write is a single message, without I2C_M_RD
+    uint8_t burst[] = {RTC_ADDR_DATE, 0x30, 0x15, 0x08};
+    CHECK(transport.write(RTC_ADDR_I2C, burst, sizeof(burst)));
+    CHECK(transport.count == 1);
+    CHECK(transport.messages[0].addr == RTC_ADDR_I2C);
+    CHECK(transport.messages[0].flags == 0);
+    CHECK(transport.messages[0].len == sizeof(burst));
+    CHECK(memcmp(transport.data[0], burst, sizeof(burst)) == 0);
+
+    //A read is a write message and a read message in one transfer, so the kernel issues a repeated START
+    uint8_t address = RTC_ADDR_DATE;
+    uint8_t registers[3];
+    CHECK(transport.writeRead(RTC_ADDR_I2C, &address, 1, registers, sizeof(registers)));
+    CHECK(transport.count == 2);
+    CHECK(transport.messages[0].addr == RTC_ADDR_I2C);
+    CHECK(transport.messages[0].flags == 0);
+    CHECK(transport.messages[0].len == 1);
+    CHECK(transport.data[0][0] == RTC_ADDR_DATE);
+    CHECK(transport.messages[1].addr == RTC_ADDR_I2C);
+    CHECK(transport.messages[1].flags == I2C_M_RD);
+    CHECK(transport.messages[1].len == sizeof(registers));
+    CHECK(transport.messages[1].buf == registers);
+    CHECK(memcmp(registers, burst + 1, sizeof(registers)) == 0);
+
+    //Failures of the transfer are returned by both methods
+    transport.fail = true;
+    CHECK(!transport.write(RTC_ADDR_I2C, burst, sizeof(burst)));
+    CHECK(!transport.writeRead(RTC_ADDR_I2C, &address, 1, registers, sizeof(registers)));
+
+    //And reach the library, which leaves the clock unchanged
+    BaseClock::setTransport(transport);
+    RealTimeClock clock;
+    transport.fail = false;
+    clock.writeDateTime(2030, 6, 15, 8, 15, 30);
+    CHECK(clock.readDateTime());
+    CHECK(transport.count == 2);
+    CHECK(transport.messages[1].len == RTC_TIME_BLOCK_SIZE);
+    transport.fail = true;
+    CHECK(!clock.readDateTime());
+    CHECK(clock.getYear() == 2030 && clock.getMinute() == 15);
+
+    //Without a character device, nothing is opened and every transfer fails
+    LinuxI2cTransport closed("/nonexistent/i2c-dev");
+    closed.begin();
+    CHECK(!closed.isOpen());
+    CHECK(!closed.write(RTC_ADDR_I2C, burst, sizeof(burst)));
+    CHECK(!closed.writeRead(RTC_ADDR_I2C, &address, 1, registers, sizeof(registers)));
+
+    return CHECK_RESULT();
+}
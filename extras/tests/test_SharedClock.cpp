@@ -0,0 +1,117 @@
+/*
+ * Copyright 2015 Daniel Murari Boatto
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <unistd.h>
+#include <atomic>
+#include "Check.h"
+#include "Device.h"
+#include "RealTimeClock.h"
+#include "SharedClock.h"
+#include "Simulator.h"
+
+using namespace Ampliar::DS3231;
+
+/**
+ * Transport that runs the simulated device on CLOCK_MONOTONIC, so the poller thread sees the seconds advance in real
+ * time. Only the poller uses it, so the simulator is never accessed concurrently.
+ */
+class RealTimeTransport : public BusTransport
+{
+public:
+    RealTimeTransport(Simulator& simulator):
+        simulator(simulator), frozen(false), transfers(0), lastMicros(TimeSeqlock::monotonicMicros())
+    {
+    }
+
+    void begin()
+    {
+    }
+
+    bool write(uint8_t address, const uint8_t* data, uint8_t length)
+    {
+        run();
+        return simulator.write(address, data, length);
+    }
+
+    bool writeRead(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength)
+    {
+        run();
+        return simulator.writeRead(address, tx, txLength, rx, rxLength);
+    }
+
+    Simulator& simulator;
+    std::atomic<bool> frozen;
+    std::atomic<uint32_t> transfers;
+
+private:
+    /**
+     * Advances the simulator up to the current time, unless it is frozen (like a stopped oscillator).
+     */
+    void run()
+    {
+        transfers++;
+        uint32_t millis = (uint32_t)((TimeSeqlock::monotonicMicros() - lastMicros) / 1000);
+        lastMicros += millis * 1000ULL;
+        if (!frozen)
+        {
+            simulator.advance(millis);
+        }
+    }
+
+    uint64_t lastMicros;
+};
+
+int main()
+{
+    Simulator simulator;
+    simulator.powerOn();
+    RealTimeTransport transport(simulator);
+    Device device(transport);
+    RealTimeClock clock(device);
+    clock.writeDateTime(2030, 6, 15, 8, 15, 30);
+
+    SharedClock shared(device);
+    CHECK(shared.start());
+    usleep(1500000);
+    TimeSample sample;
+    CHECK(shared.read(sample) && !sample.stale);
+    uint32_t published = sample.unixTime;
+
+    //While the seconds do not advance, the reads back off, and the sample is flagged as stale
+    transport.frozen = true;
+    usleep(1500000);
+    uint32_t reads = shared.getReadCount();
+    usleep(2000000);
+    CHECK(shared.getReadCount() - reads <= 4);
+    CHECK(shared.read(sample) && sample.stale && sample.unixTime == published);
+
+    //And the poller recovers when they advance again
+    transport.frozen = false;
+    usleep(3000000);
+    CHECK(shared.read(sample) && !sample.stale && sample.unixTime > published);
+    shared.stop();
+
+    //A device that does not answer is read with backoff as well, and no sample is published
+    Device missing(transport, 0x57);
+    SharedClock lost(missing);
+    uint32_t transfers = transport.transfers;
+    CHECK(lost.start());
+    usleep(1000000);
+    lost.stop();
+    CHECK(transport.transfers - transfers <= 12);
+    CHECK(lost.getReadCount() == 0 && !lost.read(sample));
+
+    return CHECK_RESULT();
+}